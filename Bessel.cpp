@@ -29,6 +29,226 @@ namespace Dsp {
 
         //------------------------------------------------------------------------------
 
+        // The roots of the reverse Bessel polynomials of orders 1 to
+        // tableOrders, found in double-double arithmetic and printed to 17
+        // digits by Tests/PoleTables.cpp, which also checks them. Solving in
+        // double loses about a digit every order, to 1e-3 at order 25, so
+        // the table is the more accurate; higher orders are still solved.
+        // Each order lists its roots in the order design() uses them: one
+        // of each conjugate pair, then the real root of an odd order.
+
+        static const int tableOrders = 25;
+
+        static const complex_t poleTable[] =
+        {
+            // order 1
+            complex_t(-1, 0),
+            // order 2
+            complex_t(-1.5, 0.8660254037844386),
+            // order 3
+            complex_t(-1.8389073226869572, 1.7543809597837217),
+            complex_t(-2.3221853546260856, 0),
+            // order 4
+            complex_t(-2.1037893971796278, 2.6574180418567526),
+            complex_t(-2.8962106028203722, 0.8672341289345038),
+            // order 5
+            complex_t(-2.324674303181645, 3.5710229203379762),
+            complex_t(-3.3519563991535333, 1.7426614161831977),
+            complex_t(-3.6467385953296434, 0),
+            // order 6
+            complex_t(-2.5159322478108215, 4.4926729536539423),
+            complex_t(-3.7357083563258149, 2.6262723114471256),
+            complex_t(-4.2483593958633641, 0.86750967323136563),
+            // order 7
+            complex_t(-2.6856768789432657, 5.4206941307167487),
+            complex_t(-4.0701391636381379, 3.5171740477097533),
+            complex_t(-4.7582905281546291, 1.7392860611305365),
+            complex_t(-4.9717868585279357, 0),
+            // order 8
+            complex_t(-2.8389839488976305, 6.3539112986048769),
+            complex_t(-4.3682892172024026, 4.4144425004715391),
+            complex_t(-5.2048407906368821, 2.6161751526425276),
+            complex_t(-5.5878860432630848, 0.86761444535278642),
+            // order 9
+            complex_t(-2.9792607981800714, 7.2914636883421817),
+            complex_t(-4.6384398871803905, 5.3172716754356513),
+            complex_t(-5.6044218195077811, 3.4981569178860936),
+            complex_t(-6.1293679042742726, 1.7378483834808625),
+            complex_t(-6.2970191817149681, 0),
+            // order 10
+            complex_t(-3.1089162336490981, 8.2326994590735882),
+            complex_t(-4.8862195668589994, 6.2249854824715669),
+            complex_t(-5.967528328587786, 4.3849471889419318),
+            complex_t(-6.6152909654768699, 2.6115679208000899),
+            complex_t(-6.9220449054272457, 0.86766519545122145),
+            // order 11
+            complex_t(-3.2297220899203061, 9.1771115687085789),
+            complex_t(-5.1156482839082793, 7.1370207588933665),
+            complex_t(-6.3013374548713088, 5.276191743696768),
+            complex_t(-7.0578923876699529, 3.4890145035558295),
+            complex_t(-7.4842298607319391, 1.7371028207534038),
+            complex_t(-7.6223398457964295, 0),
+            // order 12
+            complex_t(-3.3430233078025333, 10.124296807240819),
+            complex_t(-5.3297085908758293, 8.0529068642570323),
+            complex_t(-6.6110042499563519, 6.1715349930372296),
+            complex_t(-7.4655712403517702, 4.3701695933545652),
+            complex_t(-7.9972705996014346, 2.6090665369457984),
+            complex_t(-8.2534220114120806, 0.86769357200976882),
+            // order 13
+            complex_t(-3.4498672206287231, 11.073928552216197),
+            complex_t(-5.5306809833440367, 8.9722477751557879),
+            complex_t(-6.9003728261466595, 7.0706443121529485),
+            complex_t(-7.8443802770625961, 5.2549034066119615),
+            complex_t(-8.470591771477185, 3.4838684506609932),
+            complex_t(-8.8302520841449041, 1.7366664003076306),
+            complex_t(-8.9477096743917919, 0),
+            // order 14
+            complex_t(-3.5510868833806262, 12.025738032254525),
+            complex_t(-5.7203523838275192, 9.894707597489159),
+            complex_t(-7.1723959621718176, 7.9732173541849685),
+            complex_t(-8.198846969988475, 6.1430410714707966),
+            complex_t(-8.9110005553750451, 4.3616041783024473),
+            complex_t(-9.363145851609552, 2.6075533243816666),
+            complex_t(-9.5831713936469658, 0.86771102886425322),
+            // order 15
+            complex_t(-3.6473568624883024, 12.979501070760419),
+            complex_t(-5.9001517136646475, 10.819999137753573),
+            complex_t(-7.4293969929421539, 8.8789826211215157),
+            complex_t(-8.532459052298341, 7.0343936255170458),
+            complex_t(-9.3235993206089702, 5.242258895237617),
+            complex_t(-9.8595672283962799, 3.4806712114327665),
+            complex_t(-10.170913996440069, 1.736388919450456),
+            complex_t(-10.273109666322478, 0),
+            // order 16
+            complex_t(-3.7392317971608726, 13.935028475813382),
+            complex_t(-6.0712413829087, 11.747874938480889),
+            complex_t(-7.67324079086716, 9.7876974383690687),
+            complex_t(-8.8479681965027854, 7.9287728558893713),
+            complex_t(-9.712326332563503, 6.1257608910217671),
+            complex_t(-10.325119602341463, 4.3561633806096083),
+            complex_t(-10.718985818978014, 2.6065670072582896),
+            complex_t(-10.911886078677503, 0.86772252743572043),
+            // order 17
+            complex_t(-3.827173785099387, 14.892158924664288),
+            complex_t(-6.2345809783604134, 12.678120229066504),
+            complex_t(-7.9054495959373421, 10.699145075465168),
+            complex_t(-9.1475886776031547, 8.8259983014933336),
+            complex_t(-10.080294444857781, 7.0120099826937681),
+            complex_t(-10.764134177562843, 5.234074902036876),
+            complex_t(-11.233436817269544, 3.4785438907646968),
+            complex_t(-11.50807677713976, 1.7362015379080633),
+            complex_t(-11.59852949233955, 0),
+            // order 18
+            complex_t(-3.9115722911554083, 15.850753596937734),
+            complex_t(-6.3909727836839751, 13.610547349091433),
+            complex_t(-8.1272839450956251, 11.613131751195994),
+            complex_t(-9.4331322208087123, 9.7259003141284577),
+            complex_t(-10.430012965302145, 7.9008931033130354),
+            complex_t(-11.180039016537041, 6.1143940930369958),
+            complex_t(-11.71894879565529, 4.3524797542998348),
+            complex_t(-12.068135844936773, 2.6058878817334543),
+            complex_t(-12.23990213682503, 0.86773050053060941),
+            // order 19
+            complex_t(-3.992758917882353, 16.810692060111624),
+            complex_t(-6.5410950621614141, 14.544991303021211),
+            complex_t(-8.3398007191367363, 12.529483823944624),
+            complex_t(-9.7061024007582493, 10.628321100246287),
+            complex_t(-10.763538440003279, 8.7922930216730268),
+            complex_t(-11.575601065403184, 6.9970763747012574),
+            complex_t(-12.179231260382938, 5.2284505483908976),
+            complex_t(-12.597062809664761, 3.4770549001066771),
+            complex_t(-12.842827796895222, 1.7360690509027332),
+            complex_t(-12.923963055423728, 0),
+            // order 20
+            complex_t(-4.0710185618163175, 17.771869068885454),
+            complex_t(-6.6855268782951898, 15.481306187923618),
+            complex_t(-8.5438957268500317, 13.4480452734197),
+            complex_t(-9.9677624788603918, 11.533114728516246),
+            complex_t(-11.082580333731151, 9.6860932418285781),
+            complex_t(-11.953090802499988, 7.8820584342474502),
+            complex_t(-12.617281316609851, 6.1064798700523966),
+            complex_t(-13.098822474577164, 4.3498649117914621),
+            complex_t(-13.412597143606602, 2.6054001471794974),
+            complex_t(-13.567424283153313, 0.86773625495579831),
+            // order 21
+            complex_t(-4.1465979745037593, 18.734192042827619),
+            complex_t(-6.8247669340925112, 16.419362299287279),
+            complex_t(-8.7403355643896194, 14.368675493561163),
+            complex_t(-10.219185263216106, 12.440146622437654),
+            complex_t(-11.388577061608505, 10.582180716542792),
+            complex_t(-12.314397739182898, 8.769266832204881),
+            complex_t(-13.035560639093356, 6.9865584063400856),
+            complex_t(-13.576620861274955, 5.2244089003995677),
+            complex_t(-13.953409203515717, 3.4759711131772244),
+            complex_t(-14.175845496671846, 1.7359719206233315),
+            complex_t(-14.249406524901454, 0),
+            // order 22
+            complex_t(-4.2197124255931637, 19.697579055111127),
+            complex_t(-6.9592480853755019, 17.359043767554404),
+            complex_t(-8.9297818650887617, 15.291247379702948),
+            complex_t(-10.461290480000979, 13.349292816358346),
+            complex_t(-11.682751935116007, 11.480447284083249),
+            complex_t(-12.661113585796819, 9.6586233161268247),
+            complex_t(-13.436119716133678, 7.8686561367680117),
+            complex_t(-14.033093278163401, 6.1007311041155239),
+            complex_t(-14.468661837243712, 4.3479393817576817),
+            complex_t(-14.753642438598609, 2.6050379512520454),
+            complex_t(-14.894584352889364, 0.86774054364344333),
+            // order 23
+            complex_t(-4.2905509550549947, 20.661957211655718),
+            complex_t(-7.0893486838986295, 18.300246613328696),
+            complex_t(-9.1128100409704249, 16.215645679351905),
+            complex_t(-10.694873269930538, 14.260439124918053),
+            complex_t(-11.966155142125356, 12.380790350209562),
+            complex_t(-12.994593495537776, 10.550048126963166),
+            complex_t(-13.820687374248486, 8.7527301662786137),
+            complex_t(-14.470436457836215, 6.9788447232341255),
+            complex_t(-14.961149894475325, 5.2214021041367493),
+            complex_t(-15.304390656735237, 3.4751572561932176),
+            complex_t(-15.507575342651251, 1.7358985923766166),
+            complex_t(-15.57485737307154, 0),
+            // order 24
+            complex_t(-4.3592805610471617, 21.627261332209937),
+            complex_t(-7.2154015496007329, 19.242877135507261),
+            complex_t(-9.2899239655805772, 17.14176557277716),
+            complex_t(-10.920626250431331, 15.173480305977877),
+            complex_t(-12.239695793076095, 13.283113122256205),
+            complex_t(-13.316002054892769, 11.443462054422531),
+            complex_t(-14.190736746990391, 9.6387298415653806),
+            complex_t(-14.890503832962505, 7.8587422089579198),
+            complex_t(-15.433204545102056, 6.0964152821251663),
+            complex_t(-15.831032889792576, 4.3464792019600447),
+            complex_t(-16.092120722518167, 2.6047615575773193),
+            complex_t(-16.221471088005639, 0.86774382523318516),
+            // order 25
+            complex_t(-4.426049574071369, 22.593432867606541),
+            complex_t(-7.3377011478854923, 20.186850566211142),
+            complex_t(-9.4615676184648336, 18.069511451082214),
+            complex_t(-11.139156829490259, 16.088319258367743),
+            complex_t(-12.504166758630724, 14.18732457932364),
+            complex_t(-13.626348417459317, 12.33878769890522),
+            complex_t(-14.547534843182055, 10.526600135362813),
+            complex_t(-15.294875784329093, 8.7404021432491898),
+            complex_t(-15.886793808159393, 6.9730064585452416),
+            complex_t(-16.336025000097457, 5.2191020911969872),
+            complex_t(-16.65130125438597, 3.4745303102407772),
+            complex_t(-16.838322031500798, 1.7358418756062886),
+            complex_t(-16.900313864686478, 0),
+        };
+
+        // Poles of the order, or 0 if it is not in the table
+        static const complex_t* tablePoles(int numPoles)
+        {
+            if (numPoles < 1 || numPoles > tableOrders)
+                return 0;
+
+            // orders before numPoles take numPoles * numPoles / 4 entries
+            return poleTable + numPoles * numPoles / 4;
+        }
+
+        //------------------------------------------------------------------------------
+
         AnalogLowPass::AnalogLowPass()
             : m_numPoles(-1)
         {
@@ -44,20 +264,25 @@ namespace Dsp {
 
                 reset();
 
-                RootFinderBase& solver(w->roots);
-                for (int i = 0; i < numPoles + 1; ++i)
-                    solver.coef()[i] = reversebessel(i, numPoles);
-                solver.solve(numPoles);
+                const complex_t* roots = tablePoles(numPoles);
+                if (!roots)
+                {
+                    RootFinderBase& solver(w->roots);
+                    for (int i = 0; i < numPoles + 1; ++i)
+                        solver.coef()[i] = reversebessel(i, numPoles);
+                    solver.solve(numPoles);
+                    roots = solver.root();
+                }
 
                 const int pairs = numPoles / 2;
                 for (int i = 0; i < pairs; ++i)
                 {
-                    complex_t c = solver.root()[i];
+                    complex_t c = roots[i];
                     addPoleZeroConjugatePairs(c, infinity());
                 }
 
                 if (numPoles & 1)
-                    add(solver.root()[pairs].real(), infinity());
+                    add(roots[pairs].real(), infinity());
             }
         }
 
@@ -83,10 +308,15 @@ namespace Dsp {
 
                 const double G = pow(10., gainDb / 20) - 1;
 
-                RootFinderBase& poles(w->roots);
-                for (int i = 0; i < numPoles + 1; ++i)
-                    poles.coef()[i] = reversebessel(i, numPoles);
-                poles.solve(numPoles);
+                const complex_t* poles = tablePoles(numPoles);
+                if (!poles)
+                {
+                    RootFinderBase& solver(w->roots);
+                    for (int i = 0; i < numPoles + 1; ++i)
+                        solver.coef()[i] = reversebessel(i, numPoles);
+                    solver.solve(numPoles);
+                    poles = solver.root();
+                }
 
                 RootFinder<50> zeros;
                 for (int i = 0; i < numPoles + 1; ++i)
@@ -98,13 +328,13 @@ namespace Dsp {
                 const int pairs = numPoles / 2;
                 for (int i = 0; i < pairs; ++i)
                 {
-                    complex_t p = poles.root()[i];
+                    complex_t p = poles[i];
                     complex_t z = zeros.root()[i];
                     addPoleZeroConjugatePairs(p, z);
                 }
 
                 if (numPoles & 1)
-                    add(poles.root()[pairs].real(), zeros.root()[pairs].real());
+                    add(poles[pairs].real(), zeros.root()[pairs].real());
             }
         }
 
@@ -115,6 +345,11 @@ namespace Dsp {
             double cutoffFrequency,
             WorkspaceBase* w)
         {
+            const DesignCache::Key key(DesignCache::familyBessel, kindLowPass, order,
+                cutoffFrequency / sampleRate);
+            if (DesignCache::load(key, *this))
+                return;
+
             m_analogProto.design(order, w);
 
             LowPassTransform(cutoffFrequency / sampleRate,
@@ -122,6 +357,8 @@ namespace Dsp {
                 m_analogProto);
 
             Cascade::setLayout(m_digitalProto);
+
+            DesignCache::store(key, *this);
         }
 
         void HighPassBase::setup(int order,
@@ -129,6 +366,11 @@ namespace Dsp {
             double cutoffFrequency,
             WorkspaceBase* w)
         {
+            const DesignCache::Key key(DesignCache::familyBessel, kindHighPass, order,
+                cutoffFrequency / sampleRate);
+            if (DesignCache::load(key, *this))
+                return;
+
             m_analogProto.design(order, w);
 
             HighPassTransform(cutoffFrequency / sampleRate,
@@ -136,6 +378,8 @@ namespace Dsp {
                 m_analogProto);
 
             Cascade::setLayout(m_digitalProto);
+
+            DesignCache::store(key, *this);
         }
 
         void BandPassBase::setup(int order,
@@ -144,6 +388,11 @@ namespace Dsp {
             double widthFrequency,
             WorkspaceBase* w)
         {
+            const DesignCache::Key key(DesignCache::familyBessel, kindBandPass, order,
+                centerFrequency / sampleRate, widthFrequency / sampleRate);
+            if (DesignCache::load(key, *this))
+                return;
+
             m_analogProto.design(order, w);
 
             BandPassTransform(centerFrequency / sampleRate,
@@ -152,6 +401,8 @@ namespace Dsp {
                 m_analogProto);
 
             Cascade::setLayout(m_digitalProto);
+
+            DesignCache::store(key, *this);
         }
 
         void BandStopBase::setup(int order,
@@ -160,6 +411,11 @@ namespace Dsp {
             double widthFrequency,
             WorkspaceBase* w)
         {
+            const DesignCache::Key key(DesignCache::familyBessel, kindBandStop, order,
+                centerFrequency / sampleRate, widthFrequency / sampleRate);
+            if (DesignCache::load(key, *this))
+                return;
+
             m_analogProto.design(order, w);
 
             BandStopTransform(centerFrequency / sampleRate,
@@ -168,6 +424,8 @@ namespace Dsp {
                 m_analogProto);
 
             Cascade::setLayout(m_digitalProto);
+
+            DesignCache::store(key, *this);
         }
 
         void LowShelfBase::setup(int order,
@@ -176,6 +434,11 @@ namespace Dsp {
             double gainDb,
             WorkspaceBase* w)
         {
+            const DesignCache::Key key(DesignCache::familyBessel, kindLowShelf, order,
+                cutoffFrequency / sampleRate, 0, gainDb);
+            if (DesignCache::load(key, *this))
+                return;
+
             m_analogProto.design(order, gainDb, w);
 
             LowPassTransform(cutoffFrequency / sampleRate,
@@ -183,6 +446,8 @@ namespace Dsp {
                 m_analogProto);
 
             Cascade::setLayout(m_digitalProto);
+
+            DesignCache::store(key, *this);
         }
 
     }
@@ -74,6 +74,46 @@ namespace Dsp {
         return ch / cbot;
     }
 
+    void BiquadBase::responseGrid(const double* normalizedFrequencies,
+        int numFrequencies,
+        complex_t* response) const
+    {
+        const BiquadCoefficients<double> stage(*this);
+        gridResponse(FrequencyGrid(normalizedFrequencies, numFrequencies),
+            1, &stage, response);
+    }
+
+    void BiquadBase::responseGrid(double first,
+        double last,
+        int numFrequencies,
+        Spacing spacing,
+        complex_t* response) const
+    {
+        const BiquadCoefficients<double> stage(*this);
+        gridResponse(FrequencyGrid(first, last, numFrequencies, spacing),
+            1, &stage, response);
+    }
+
+    void BiquadBase::magnitudeDbGrid(const double* normalizedFrequencies,
+        int numFrequencies,
+        double* magnitudeDb) const
+    {
+        const BiquadCoefficients<double> stage(*this);
+        gridMagnitudeDb(FrequencyGrid(normalizedFrequencies, numFrequencies),
+            1, &stage, magnitudeDb);
+    }
+
+    void BiquadBase::magnitudeDbGrid(double first,
+        double last,
+        int numFrequencies,
+        Spacing spacing,
+        double* magnitudeDb) const
+    {
+        const BiquadCoefficients<double> stage(*this);
+        gridMagnitudeDb(FrequencyGrid(first, last, numFrequencies, spacing),
+            1, &stage, magnitudeDb);
+    }
+
     std::vector<PoleZeroPair> BiquadBase::getPoleZeros() const
     {
         std::vector<PoleZeroPair> vpz;
@@ -82,6 +122,13 @@ namespace Dsp {
         return vpz;
     }
 
+    int BiquadBase::getPoleZeros(PoleZeroPair* pairs, int maxPairs) const
+    {
+        if (maxPairs > 0)
+            pairs[0] = BiquadPoleState(*this);
+        return 1;
+    }
+
     void BiquadBase::setCoefficients(double a0, double a1, double a2,
         double b0, double b1, double b2)
     {
@@ -94,6 +141,8 @@ namespace Dsp {
         m_b0 = b0 / a0;
         m_b1 = b1 / a0;
         m_b2 = b2 / a0;
+        updateFloatCoefficients();
+        updateFixedCoefficients();
     }
 
     void BiquadBase::setOnePole(complex_t pole, complex_t zero)
@@ -183,6 +232,8 @@ namespace Dsp {
         m_b0 *= scale;
         m_b1 *= scale;
         m_b2 *= scale;
+        updateFloatCoefficients();
+        updateFixedCoefficients();
     }
 
     //------------------------------------------------------------------------------
@@ -199,4 +250,200 @@ namespace Dsp {
 
     //------------------------------------------------------------------------------
 
+    namespace {
+
+        // Points evaluated at a time, a multiple of every vector width
+        const int gridBlock = 64;
+
+        // Largest change of the step angle for which the series in
+        // GridWalker::logarithmic are exact in double precision
+        const double maxStepChange = 1e-3;
+
+        // Gives cos w and sin w for the points of a grid, a block at a time.
+        // Each block starts from cos and sin of its first point and steps
+        // to the others by complex rotation: by a fixed angle on a linear
+        // grid, and on a logarithmic one by an angle that itself grows by a
+        // small rotation each point.
+        class GridWalker
+        {
+        public:
+            explicit GridWalker(const FrequencyGrid& grid)
+                : m_grid(grid)
+                , m_index(0)
+                , m_step(0)
+                , m_growth(0)
+                , m_stepCos(1)
+                , m_stepSin(0)
+            {
+                const int n = grid.numFrequencies;
+                if (grid.frequencies || n < 2)
+                    return;
+
+                if (grid.spacing == spacingLogarithmic)
+                {
+                    assert(grid.first > 0 && grid.last > 0);
+                    // the ratio of neighbouring points less one, exactly
+                    m_growth = std::expm1(std::log(grid.last / grid.first) / (n - 1));
+                }
+                else
+                {
+                    m_step = (grid.last - grid.first) / (n - 1);
+                    const double w = 2 * doublePi * m_step;
+                    m_stepCos = std::cos(w);
+                    m_stepSin = std::sin(w);
+                }
+            }
+
+            // Fills the next block and returns its size, 0 at the end
+            int next(double* cosines, double* sines)
+            {
+                const int count = std::min(gridBlock,
+                    m_grid.numFrequencies - m_index);
+
+                if (m_grid.frequencies)
+                    direct(count, m_grid.frequencies + m_index, cosines, sines);
+                else if (m_grid.spacing == spacingLogarithmic)
+                    logarithmic(count, cosines, sines);
+                else
+                    linear(count, cosines, sines);
+
+                m_index += count;
+                return count;
+            }
+
+        private:
+            double getFrequency(int index) const
+            {
+                if (m_grid.spacing == spacingLogarithmic)
+                    return m_grid.first * std::pow(1 + m_growth, index);
+                else
+                    return m_grid.first + index * m_step;
+            }
+
+            static void direct(int count, const double* frequencies,
+                double* cosines, double* sines)
+            {
+                for (int i = 0; i < count; ++i)
+                {
+                    const double w = 2 * doublePi * frequencies[i];
+                    cosines[i] = std::cos(w);
+                    sines[i] = std::sin(w);
+                }
+            }
+
+            void linear(int count, double* cosines, double* sines) const
+            {
+                const double w = 2 * doublePi * getFrequency(m_index);
+                double c = std::cos(w);
+                double s = std::sin(w);
+                for (int i = 0; i < count; ++i)
+                {
+                    cosines[i] = c;
+                    sines[i] = s;
+                    const double t = c * m_stepCos - s * m_stepSin;
+                    s = s * m_stepCos + c * m_stepSin;
+                    c = t;
+                }
+            }
+
+            // The step to the next point is w (r - 1) for a ratio r, and
+            // grows by the step times (r - 1) itself.
+            void logarithmic(int count, double* cosines, double* sines) const
+            {
+                const double w = 2 * doublePi * getFrequency(m_index);
+                const double step = w * m_growth;
+                double change = step * m_growth;
+                if (change * std::pow(1 + m_growth, count) > maxStepChange)
+                {
+                    // too coarse for the series, evaluate every point
+                    for (int i = 0; i < count; ++i)
+                    {
+                        const double v = 2 * doublePi * getFrequency(m_index + i);
+                        cosines[i] = std::cos(v);
+                        sines[i] = std::sin(v);
+                    }
+                    return;
+                }
+
+                double c = std::cos(w);
+                double s = std::sin(w);
+                double sc = std::cos(step);
+                double ss = std::sin(step);
+                for (int i = 0; i < count; ++i)
+                {
+                    cosines[i] = c;
+                    sines[i] = s;
+                    const double t = c * sc - s * ss;
+                    s = s * sc + c * ss;
+                    c = t;
+
+                    // rotate the step by the change, cos and sin as series
+                    const double e2 = change * change;
+                    const double ec = 1 - e2 * (1. / 2 - e2 * (1. / 24));
+                    const double es = change * (1 - e2 * (1. / 6 - e2 * (1. / 120)));
+                    const double u = sc * ec - ss * es;
+                    ss = ss * ec + sc * es;
+                    sc = u;
+                    change *= 1 + m_growth;
+                }
+            }
+
+        private:
+            const FrequencyGrid& m_grid;
+            int m_index;
+            double m_step;
+            double m_growth;
+            double m_stepCos;
+            double m_stepSin;
+        };
+
+    }
+
+    void gridResponse(const FrequencyGrid& grid,
+        int numStages,
+        const BiquadCoefficients<double>* stageArray,
+        complex_t* response)
+    {
+        double cosines[gridBlock];
+        double sines[gridBlock];
+        double real[gridBlock];
+        double imag[gridBlock];
+        double power[gridBlock];
+
+        GridWalker walker(grid);
+        for (int count; (count = walker.next(cosines, sines)) > 0; response += count)
+        {
+            Dispatch::response(count, cosines, sines, numStages, stageArray,
+                real, imag, power);
+
+            for (int i = 0; i < count; ++i)
+            {
+                const double scale = 1 / power[i];
+                response[i] = complex_t(real[i] * scale, imag[i] * scale);
+            }
+        }
+    }
+
+    void gridMagnitudeDb(const FrequencyGrid& grid,
+        int numStages,
+        const BiquadCoefficients<double>* stageArray,
+        double* magnitudeDb)
+    {
+        double cosines[gridBlock];
+        double sines[gridBlock];
+        double numerator[gridBlock];
+        double denominator[gridBlock];
+
+        GridWalker walker(grid);
+        for (int count; (count = walker.next(cosines, sines)) > 0; magnitudeDb += count)
+        {
+            Dispatch::magnitude(count, cosines, sines, numStages, stageArray,
+                numerator, denominator);
+
+            // squared magnitudes, hence 10
+            for (int i = 0; i < count; ++i)
+                magnitudeDb[i] = 10 * std::log10(numerator[i] / denominator[i]);
+        }
+    }
+
 }
@@ -2,7 +2,9 @@
 #define DSPFILTERS_BIQUAD_H
 
 #include "Common.h"
+#include "Dispatch.h"
 #include "MathSupplement.h"
+#include "Simd.h"
 #include "Types.h"
 
 namespace Dsp {
@@ -19,13 +21,63 @@ namespace Dsp {
     class BiquadBase
     {
     public:
-        template <class StateType>
-        struct State : StateType, private DenormalPrevention
+        template <class StateType, class Denormal = DenormalPrevention>
+        struct State : StateType, private Denormal
         {
+            typedef StateType state_type_t;
+            typedef Denormal denormal_t;
+
             template <typename Sample>
             inline Sample process(const Sample in, const BiquadBase& b)
             {
-                return static_cast<Sample> (StateType::process1(in, b, ac()));
+                return static_cast<Sample> (StateType::process1(in, b, this->ac()));
+            }
+
+            // Number of samples by which the output lags the input
+            static int getLatency(const BiquadBase&)
+            {
+                return 0;
+            }
+
+            /*@Internal*/
+            // Process several channels out of place through a section that
+            // changes every sample, the one of sample n at trajectory[n].
+            // A lone section does too little to pay for moving the channels
+            // in and out of SIMD lanes, so they take turns at each sample.
+            template <class ChannelState, typename Source, typename Sample>
+            static void processTrajectory(int numSamples,
+                int numChannels,
+                const Source* const* sourceChannels,
+                Sample* const* arrayOfChannels,
+                ChannelState* stateArray,
+                int numStages,
+                const BiquadCoefficients<typename StateType::value_type>* trajectory,
+                int stride)
+            {
+                assert(numStages == 1);
+
+                typename Denormal::Scope scope;
+                for (int n = 0; n < numSamples; ++n, ++trajectory)
+                    for (int i = 0; i < numChannels; ++i)
+                    {
+                        const int k = n * stride;
+                        arrayOfChannels[i][k] = static_cast<Sample> (
+                            stateArray[i].process1(
+                                static_cast<Sample>(sourceChannels[i][k]),
+                                *trajectory, stateArray[i].ac()));
+                    }
+            }
+
+            /*@Internal*/
+            StateType* getStateArray()
+            {
+                return this;
+            }
+
+            /*@Internal*/
+            DenormalPrevention& getDenormalPrevention()
+            {
+                return *this;
             }
         };
 
@@ -33,8 +85,38 @@ namespace Dsp {
         // Calculate filter response at the given normalized frequency.
         complex_t response(double normalizedFrequency) const;
 
+        // Calculate the response at each of numFrequencies normalized
+        // frequencies, many at a time in SIMD lanes. The results agree with
+        // response() to within rounding.
+        void responseGrid(const double* normalizedFrequencies,
+            int numFrequencies,
+            complex_t* response) const;
+
+        // The same at numFrequencies points from first to last, both
+        // included, with linear or logarithmic spacing
+        void responseGrid(double first,
+            double last,
+            int numFrequencies,
+            Spacing spacing,
+            complex_t* response) const;
+
+        // The magnitude of the response in decibels
+        void magnitudeDbGrid(const double* normalizedFrequencies,
+            int numFrequencies,
+            double* magnitudeDb) const;
+
+        void magnitudeDbGrid(double first,
+            double last,
+            int numFrequencies,
+            Spacing spacing,
+            double* magnitudeDb) const;
+
         std::vector<PoleZeroPair> getPoleZeros() const;
 
+        // Copy up to maxPairs pole/zero pairs into pairs without allocating
+        // memory, and return how many pairs there are in all
+        int getPoleZeros(PoleZeroPair* pairs, int maxPairs) const;
+
         double getA0() const { return m_a0; }
         double getA1() const { return m_a1 * m_a0; }
         double getA2() const { return m_a2 * m_a0; }
@@ -42,16 +124,79 @@ namespace Dsp {
         double getB1() const { return m_b1 * m_a0; }
         double getB2() const { return m_b2 * m_a0; }
 
+        // The number of coefficients that are not zero but round to zero
+        // in the precision of Value, which only the fixed point forms can
+        // lose, see DirectFormIQ15
+        template <typename Value>
+        int getLostCoefficients() const;
+
         // Process a block of samples in the given form
         template <class StateType, typename Sample>
         void process(int numSamples, Sample* dest, StateType& state) const
         {
+            typename StateType::denormal_t::Scope scope;
             while (--numSamples >= 0) {
                 *dest = state.process(*dest, *this);
                 dest++;
             }
         }
 
+        // Process a block of samples out of place, converting from the
+        // source sample type. The output is identical to copying src to
+        // dest and processing dest.
+        template <class StateType, typename Source, typename Sample>
+        void process(int numSamples,
+            const Source* src,
+            Sample* dest,
+            StateType& state) const
+        {
+            typename StateType::denormal_t::Scope scope;
+            while (--numSamples >= 0)
+                *dest++ = state.process(static_cast<Sample>(*src++), *this);
+        }
+
+        // Process a block of samples for several channels, running groups
+        // of channels in parallel SIMD lanes. The output is identical to
+        // processing each channel in turn.
+        template <class ChannelState, typename Sample>
+        void process(int numSamples,
+            int numChannels,
+            Sample* const* arrayOfChannels,
+            ChannelState* stateArray) const
+        {
+            typename ChannelState::denormal_t::Scope scope;
+            processChannels(numSamples, numChannels, arrayOfChannels,
+                stateArray, 1, this);
+        }
+
+        // Process several channels out of place
+        template <class ChannelState, typename Source, typename Sample>
+        void process(int numSamples,
+            int numChannels,
+            const Source* const* sourceChannels,
+            Sample* const* arrayOfChannels,
+            ChannelState* stateArray) const
+        {
+            typename ChannelState::denormal_t::Scope scope;
+            processChannels(numSamples, numChannels, sourceChannels,
+                arrayOfChannels, stateArray, 1, this);
+        }
+
+        // Process interleaved frames in place, sample n of channel i being
+        // frames[n * frameStride + i]. Like the planar version, whole frames
+        // are loaded into the SIMD lanes.
+        template <class ChannelState, typename Sample>
+        void process(int numSamples,
+            int numChannels,
+            Sample* frames,
+            int frameStride,
+            ChannelState* stateArray) const
+        {
+            typename ChannelState::denormal_t::Scope scope;
+            processFrames(numSamples, numChannels, frames, frameStride,
+                stateArray, 1, this);
+        }
+
     protected:
         //
         // These are protected so you can't mess with RBJ biquads
@@ -80,6 +225,32 @@ namespace Dsp {
 
         void applyScale(double scale);
 
+    public:
+        /*@Internal*/
+        // Put the coefficients of Value, as read by the state forms, of
+        // from moved a fraction t of the way to to into stages[0]. At t = 1
+        // they are an exact copy of those of to. For the coefficient ramps
+        // of SmoothedFilterDesign.
+        template <typename Value>
+        static void interpolate(const BiquadBase& from,
+            const BiquadBase& to,
+            double t,
+            BiquadCoefficients<Value>* stages);
+
+    protected:
+        // Refreshes the single precision copies after the coefficients change
+        void updateFloatCoefficients()
+        {
+            m_a1f = static_cast<float>(m_a1);
+            m_a2f = static_cast<float>(m_a2);
+            m_b0f = static_cast<float>(m_b0);
+            m_b1f = static_cast<float>(m_b1);
+            m_b2f = static_cast<float>(m_b2);
+        }
+
+        // Refreshes the fixed point copies after the coefficients change
+        void updateFixedCoefficients();
+
     public:
         double m_a0;
         double m_a1;
@@ -87,8 +258,289 @@ namespace Dsp {
         double m_b1;
         double m_b2;
         double m_b0;
+
+        // Single precision copies for the float state forms
+        float m_a1f;
+        float m_a2f;
+        float m_b1f;
+        float m_b2f;
+        float m_b0f;
+
+        // Fixed point copies for the integer state forms, in Q2.14 and
+        // Q2.30. Coefficients outside [-2, 2) saturate.
+        int16_t m_a1q15;
+        int16_t m_a2q15;
+        int16_t m_b1q15;
+        int16_t m_b2q15;
+        int16_t m_b0q15;
+        int32_t m_a1q31;
+        int32_t m_a2q31;
+        int32_t m_b1q31;
+        int32_t m_b2q31;
+        int32_t m_b0q31;
+    };
+
+    template <>
+    struct Dispatch::StageIndex <BiquadBase>
+    {
+        enum { value = 0 };
+    };
+
+    //------------------------------------------------------------------------------
+
+    // The normalized coefficients of a section in the precision
+    // a state form computes in, in the order the kernels read them.
+    // Cascade keeps compiled arrays of these for its processing loops.
+    template <typename Value>
+    struct BiquadCoefficients
+    {
+        BiquadCoefficients()
+        {
+        }
+
+        explicit BiquadCoefficients(const BiquadBase& s)
+            : b0(s.m_b0)
+            , b1(s.m_b1)
+            , b2(s.m_b2)
+            , a1(s.m_a1)
+            , a2(s.m_a2)
+        {
+        }
+
+        Value b0;
+        Value b1;
+        Value b2;
+        Value a1;
+        Value a2;
+    };
+
+    template <>
+    inline BiquadCoefficients<float>::BiquadCoefficients(const BiquadBase& s)
+        : b0(s.m_b0f)
+        , b1(s.m_b1f)
+        , b2(s.m_b2f)
+        , a1(s.m_a1f)
+        , a2(s.m_a2f)
+    {
+    }
+
+    // Q2.14
+    template <>
+    inline BiquadCoefficients<int16_t>::BiquadCoefficients(const BiquadBase& s)
+        : b0(s.m_b0q15)
+        , b1(s.m_b1q15)
+        , b2(s.m_b2q15)
+        , a1(s.m_a1q15)
+        , a2(s.m_a2q15)
+    {
+    }
+
+    // Q2.30
+    template <>
+    inline BiquadCoefficients<int32_t>::BiquadCoefficients(const BiquadBase& s)
+        : b0(s.m_b0q31)
+        , b1(s.m_b1q31)
+        , b2(s.m_b2q31)
+        , a1(s.m_a1q31)
+        , a2(s.m_a2q31)
+    {
+    }
+
+    // The coefficients a fraction t of the way from a to b
+    inline BiquadCoefficients<double> interpolateCoefficients(
+        const BiquadCoefficients<double>& a,
+        const BiquadCoefficients<double>& b,
+        double t)
+    {
+        BiquadCoefficients<double> c;
+        c.b0 = a.b0 + t * (b.b0 - a.b0);
+        c.b1 = a.b1 + t * (b.b1 - a.b1);
+        c.b2 = a.b2 + t * (b.b2 - a.b2);
+        c.a1 = a.a1 + t * (b.a1 - a.a1);
+        c.a2 = a.a2 + t * (b.a2 - a.a2);
+        return c;
+    }
+
+    // Double precision coefficients in the precision of Value, rounded
+    // the same way as the copies kept by BiquadBase
+    template <typename Value>
+    inline BiquadCoefficients<Value> roundCoefficients(
+        const BiquadCoefficients<double>& c)
+    {
+        BiquadCoefficients<Value> r;
+        r.b0 = static_cast<Value>(c.b0);
+        r.b1 = static_cast<Value>(c.b1);
+        r.b2 = static_cast<Value>(c.b2);
+        r.a1 = static_cast<Value>(c.a1);
+        r.a2 = static_cast<Value>(c.a2);
+        return r;
+    }
+
+    // Double precision coefficients in fixed point with fracBits fractional
+    // bits. A zero at DC or at Nyquist on the side of the poles, as in a
+    // high pass with a low cutoff, stays exact. The poles would amplify
+    // the rounding of the zero into a leak at that end.
+    template <typename Value>
+    inline BiquadCoefficients<Value> roundFixedCoefficients(
+        const BiquadCoefficients<double>& c,
+        int fracBits)
+    {
+        BiquadCoefficients<Value> r;
+        r.b0 = toFixed<Value>(c.b0, fracBits);
+        r.b1 = toFixed<Value>(c.b1, fracBits);
+        r.b2 = toFixed<Value>(c.b2, fracBits);
+        r.a1 = toFixed<Value>(c.a1, fracBits);
+        r.a2 = toFixed<Value>(c.a2, fracBits);
+
+        const double tolerance = 8 * DBL_EPSILON * std::max(std::max(
+            std::abs(c.b0), std::abs(c.b1)), std::abs(c.b2));
+        const bool poleNearDc = std::abs(1 + c.a1 + c.a2) < std::abs(1 - c.a1 + c.a2);
+        if (poleNearDc && std::abs(c.b0 + c.b1 + c.b2) <= tolerance)
+            r.b1 = saturate<Value>(-(int64_t(r.b0) + r.b2));
+        else if (!poleNearDc && std::abs(c.b0 - c.b1 + c.b2) <= tolerance)
+            r.b1 = saturate<Value>(int64_t(r.b0) + r.b2);
+        return r;
+    }
+
+    // Q2.14
+    template <>
+    inline BiquadCoefficients<int16_t> roundCoefficients(
+        const BiquadCoefficients<double>& c)
+    {
+        return roundFixedCoefficients<int16_t>(c, 14);
+    }
+
+    // Q2.30
+    template <>
+    inline BiquadCoefficients<int32_t> roundCoefficients(
+        const BiquadCoefficients<double>& c)
+    {
+        return roundFixedCoefficients<int32_t>(c, 30);
+    }
+
+    // The values that fixed point coefficients with fracBits fractional
+    // bits stand for
+    template <typename Value>
+    inline BiquadCoefficients<double> widenCoefficients(
+        const BiquadCoefficients<Value>& c,
+        int fracBits)
+    {
+        BiquadCoefficients<double> r;
+        r.b0 = std::ldexp(double(c.b0), -fracBits);
+        r.b1 = std::ldexp(double(c.b1), -fracBits);
+        r.b2 = std::ldexp(double(c.b2), -fracBits);
+        r.a1 = std::ldexp(double(c.a1), -fracBits);
+        r.a2 = std::ldexp(double(c.a2), -fracBits);
+        return r;
+    }
+
+    // The number of coefficients of c that round to zero in r although
+    // they are more than the round-off of a zero, a few ulps of the
+    // largest coefficient of their polynomial
+    template <typename Value>
+    inline int countLostCoefficients(const BiquadCoefficients<double>& c,
+        const BiquadCoefficients<Value>& r)
+    {
+        const double b = 8 * DBL_EPSILON * std::max(std::max(std::abs(c.b0),
+            std::abs(c.b1)), std::abs(c.b2));
+        const double a = 8 * DBL_EPSILON * std::max(1.,
+            std::max(std::abs(c.a1), std::abs(c.a2)));
+        return int(std::abs(c.b0) > b && r.b0 == 0)
+            + int(std::abs(c.b1) > b && r.b1 == 0)
+            + int(std::abs(c.b2) > b && r.b2 == 0)
+            + int(std::abs(c.a1) > a && r.a1 == 0)
+            + int(std::abs(c.a2) > a && r.a2 == 0);
+    }
+
+    inline void BiquadBase::updateFixedCoefficients()
+    {
+        const BiquadCoefficients<double> c(*this);
+        const BiquadCoefficients<int16_t> q15 = roundCoefficients<int16_t>(c);
+        m_a1q15 = q15.a1;
+        m_a2q15 = q15.a2;
+        m_b0q15 = q15.b0;
+        m_b1q15 = q15.b1;
+        m_b2q15 = q15.b2;
+
+        const BiquadCoefficients<int32_t> q31 = roundCoefficients<int32_t>(c);
+        m_a1q31 = q31.a1;
+        m_a2q31 = q31.a2;
+        m_b0q31 = q31.b0;
+        m_b1q31 = q31.b1;
+        m_b2q31 = q31.b2;
+    }
+
+    template <typename Value>
+    int BiquadBase::getLostCoefficients() const
+    {
+        return countLostCoefficients(BiquadCoefficients<double>(*this),
+            BiquadCoefficients<Value>(*this));
+    }
+
+    template <typename Value>
+    void BiquadBase::interpolate(const BiquadBase& from,
+        const BiquadBase& to,
+        double t,
+        BiquadCoefficients<Value>* stages)
+    {
+        if (t >= 1)
+        {
+            stages[0] = BiquadCoefficients<Value>(to);
+            return;
+        }
+
+        stages[0] = roundCoefficients<Value>(interpolateCoefficients(
+            BiquadCoefficients<double>(from),
+            BiquadCoefficients<double>(to), t));
+    }
+
+    //------------------------------------------------------------------------------
+
+    /*@Internal*/
+    // The points of a response grid: the given frequencies, or if there are
+    // none, numFrequencies points from first to last
+    struct FrequencyGrid
+    {
+        FrequencyGrid(const double* frequencies_, int numFrequencies_)
+            : frequencies(frequencies_)
+            , numFrequencies(numFrequencies_)
+            , first(0)
+            , last(0)
+            , spacing(spacingLinear)
+        {
+        }
+
+        FrequencyGrid(double first_, double last_, int numFrequencies_,
+            Spacing spacing_)
+            : frequencies(0)
+            , numFrequencies(numFrequencies_)
+            , first(first_)
+            , last(last_)
+            , spacing(spacing_)
+        {
+        }
+
+        const double* frequencies;
+        int numFrequencies;
+        double first;
+        double last;
+        Spacing spacing;
     };
 
+    /*@Internal*/
+    // Shared implementation of responseGrid and magnitudeDbGrid for a
+    // cascade of numStages sections
+    void gridResponse(const FrequencyGrid& grid,
+        int numStages,
+        const BiquadCoefficients<double>* stageArray,
+        complex_t* response);
+
+    /*@Internal*/
+    void gridMagnitudeDb(const FrequencyGrid& grid,
+        int numStages,
+        const BiquadCoefficients<double>* stageArray,
+        double* magnitudeDb);
+
     //------------------------------------------------------------------------------
 
     // Expresses a biquad as a pair of pole/zeros, with gain
@@ -135,6 +587,8 @@ namespace Dsp {
                 sectionPrev.m_b0 += db0;
                 sectionPrev.m_b1 += db1;
                 sectionPrev.m_b2 += db2;
+                sectionPrev.updateFloatCoefficients();
+                sectionPrev.updateFixedCoefficients();
 
                 *dest = state.process(*dest, sectionPrev);
                 dest++;
@@ -174,6 +628,12 @@ namespace Dsp {
     public:
         // Export these as public
 
+        void setCoefficients(double a0, double a1, double a2,
+            double b0, double b1, double b2)
+        {
+            BiquadBase::setCoefficients(a0, a1, a2, b0, b1, b2);
+        }
+
         void setOnePole(complex_t pole, complex_t zero)
         {
             BiquadBase::setOnePole(pole, zero);
@@ -74,6 +74,11 @@ namespace Dsp {
             double sampleRate,
             double cutoffFrequency)
         {
+            const DesignCache::Key key(DesignCache::familyButterworth, kindLowPass, order,
+                cutoffFrequency / sampleRate);
+            if (DesignCache::load(key, *this))
+                return;
+
             m_analogProto.design(order);
 
             LowPassTransform(cutoffFrequency / sampleRate,
@@ -81,12 +86,19 @@ namespace Dsp {
                 m_analogProto);
 
             Cascade::setLayout(m_digitalProto);
+
+            DesignCache::store(key, *this);
         }
 
         void HighPassBase::setup(int order,
             double sampleRate,
             double cutoffFrequency)
         {
+            const DesignCache::Key key(DesignCache::familyButterworth, kindHighPass, order,
+                cutoffFrequency / sampleRate);
+            if (DesignCache::load(key, *this))
+                return;
+
             m_analogProto.design(order);
 
             HighPassTransform(cutoffFrequency / sampleRate,
@@ -94,6 +106,8 @@ namespace Dsp {
                 m_analogProto);
 
             Cascade::setLayout(m_digitalProto);
+
+            DesignCache::store(key, *this);
         }
 
         void BandPassBase::setup(int order,
@@ -101,6 +115,11 @@ namespace Dsp {
             double centerFrequency,
             double widthFrequency)
         {
+            const DesignCache::Key key(DesignCache::familyButterworth, kindBandPass, order,
+                centerFrequency / sampleRate, widthFrequency / sampleRate);
+            if (DesignCache::load(key, *this))
+                return;
+
             m_analogProto.design(order);
 
             BandPassTransform(centerFrequency / sampleRate,
@@ -109,6 +128,8 @@ namespace Dsp {
                 m_analogProto);
 
             Cascade::setLayout(m_digitalProto);
+
+            DesignCache::store(key, *this);
         }
 
         void BandStopBase::setup(int order,
@@ -116,6 +137,11 @@ namespace Dsp {
             double centerFrequency,
             double widthFrequency)
         {
+            const DesignCache::Key key(DesignCache::familyButterworth, kindBandStop, order,
+                centerFrequency / sampleRate, widthFrequency / sampleRate);
+            if (DesignCache::load(key, *this))
+                return;
+
             m_analogProto.design(order);
 
             BandStopTransform(centerFrequency / sampleRate,
@@ -124,6 +150,8 @@ namespace Dsp {
                 m_analogProto);
 
             Cascade::setLayout(m_digitalProto);
+
+            DesignCache::store(key, *this);
         }
 
         void LowShelfBase::setup(int order,
@@ -131,6 +159,11 @@ namespace Dsp {
             double cutoffFrequency,
             double gainDb)
         {
+            const DesignCache::Key key(DesignCache::familyButterworth, kindLowShelf, order,
+                cutoffFrequency / sampleRate, 0, gainDb);
+            if (DesignCache::load(key, *this))
+                return;
+
             m_analogProto.design(order, gainDb);
 
             LowPassTransform(cutoffFrequency / sampleRate,
@@ -138,6 +171,8 @@ namespace Dsp {
                 m_analogProto);
 
             Cascade::setLayout(m_digitalProto);
+
+            DesignCache::store(key, *this);
         }
 
         void HighShelfBase::setup(int order,
@@ -145,6 +180,11 @@ namespace Dsp {
             double cutoffFrequency,
             double gainDb)
         {
+            const DesignCache::Key key(DesignCache::familyButterworth, kindHighShelf, order,
+                cutoffFrequency / sampleRate, 0, gainDb);
+            if (DesignCache::load(key, *this))
+                return;
+
             m_analogProto.design(order, gainDb);
 
             HighPassTransform(cutoffFrequency / sampleRate,
@@ -152,6 +192,8 @@ namespace Dsp {
                 m_analogProto);
 
             Cascade::setLayout(m_digitalProto);
+
+            DesignCache::store(key, *this);
         }
 
         void BandShelfBase::setup(int order,
@@ -160,6 +202,11 @@ namespace Dsp {
             double widthFrequency,
             double gainDb)
         {
+            const DesignCache::Key key(DesignCache::familyButterworth, kindBandShelf, order,
+                centerFrequency / sampleRate, widthFrequency / sampleRate, gainDb);
+            if (DesignCache::load(key, *this))
+                return;
+
             m_analogProto.design(order, gainDb);
 
             BandPassTransform(centerFrequency / sampleRate,
@@ -171,6 +218,8 @@ namespace Dsp {
             m_digitalProto.setNormal(((centerFrequency / sampleRate) < 0.25) ? doublePi : 0, 1);
 
             Cascade::setLayout(m_digitalProto);
+
+            DesignCache::store(key, *this);
         }
 
     }
@@ -8,14 +8,23 @@ namespace Dsp {
         : m_numStages(0)
         , m_maxStages(0)
         , m_stageArray(0)
+        , m_compiledArray(0)
+        , m_compiledNarrowArray(0)
+        , m_narrowValue(narrowFloat)
+        , m_lostCoefficients(0)
     {
     }
 
     void Cascade::setCascadeStorage(const Storage& storage)
     {
+        // the stages are processed from the compiled arrays
+        assert(storage.compiledArray && storage.compiledNarrowArray);
+
         m_numStages = 0;
         m_maxStages = storage.maxStages;
         m_stageArray = storage.stageArray;
+        m_compiledArray = storage.compiledArray;
+        m_compiledNarrowArray = storage.compiledNarrowArray;
     }
 
     complex_t Cascade::response(double normalizedFrequency) const
@@ -42,6 +51,42 @@ namespace Dsp {
         return ch / cbot;
     }
 
+    void Cascade::responseGrid(const double* normalizedFrequencies,
+        int numFrequencies,
+        complex_t* response) const
+    {
+        gridResponse(FrequencyGrid(normalizedFrequencies, numFrequencies),
+            m_numStages, m_compiledArray, response);
+    }
+
+    void Cascade::responseGrid(double first,
+        double last,
+        int numFrequencies,
+        Spacing spacing,
+        complex_t* response) const
+    {
+        gridResponse(FrequencyGrid(first, last, numFrequencies, spacing),
+            m_numStages, m_compiledArray, response);
+    }
+
+    void Cascade::magnitudeDbGrid(const double* normalizedFrequencies,
+        int numFrequencies,
+        double* magnitudeDb) const
+    {
+        gridMagnitudeDb(FrequencyGrid(normalizedFrequencies, numFrequencies),
+            m_numStages, m_compiledArray, magnitudeDb);
+    }
+
+    void Cascade::magnitudeDbGrid(double first,
+        double last,
+        int numFrequencies,
+        Spacing spacing,
+        double* magnitudeDb) const
+    {
+        gridMagnitudeDb(FrequencyGrid(first, last, numFrequencies, spacing),
+            m_numStages, m_compiledArray, magnitudeDb);
+    }
+
     std::vector<PoleZeroPair> Cascade::getPoleZeros() const
     {
         std::vector<PoleZeroPair> vpz;
@@ -58,12 +103,21 @@ namespace Dsp {
         return vpz;
     }
 
+    int Cascade::getPoleZeros(PoleZeroPair* pairs, int maxPairs) const
+    {
+        const int count = std::min(m_numStages, maxPairs);
+        for (int i = 0; i < count; ++i)
+            pairs[i] = BiquadPoleState(m_stageArray[i]);
+        return m_numStages;
+    }
+
     void Cascade::applyScale(double scale)
     {
         // For higher order filters it might be helpful
         // to spread this factor between all the stages.
         assert(m_numStages > 0);
         m_stageArray->applyScale(scale);
+        compileStages();
     }
 
     void Cascade::setLayout(const LayoutBase& proto)
@@ -80,6 +134,103 @@ namespace Dsp {
             std::abs(response(proto.getNormalW() / (2 * doublePi))));
     }
 
+    void Cascade::setStages(int numStages, const Stage* stages)
+    {
+        assert(numStages <= m_maxStages);
+        m_numStages = numStages;
+        std::copy(stages, stages + numStages, m_stageArray);
+        compileStages();
+    }
+
+    void Cascade::compileStages()
+    {
+        assert(m_compiledArray && m_compiledNarrowArray);
+
+        for (int i = 0; i < m_numStages; ++i)
+            m_compiledArray[i] = BiquadCoefficients<double>(m_stageArray[i]);
+
+        switch (m_narrowValue)
+        {
+        case narrowFloat: compileNarrowStages<float>(); break;
+        case narrowQ15: compileNarrowStages<int16_t>(); break;
+        case narrowQ31: compileNarrowStages<int32_t>(); break;
+        }
+    }
+
+    template <typename Value>
+    void Cascade::compileNarrowStages()
+    {
+        // the narrow array holds the sections of one value type at a time
+        BiquadCoefficients<Value>* compiled =
+            reinterpret_cast<BiquadCoefficients<Value>*>(m_compiledNarrowArray);
+        for (int i = 0; i < m_numStages; ++i)
+            new (compiled + i) BiquadCoefficients<Value>();
+        m_lostCoefficients = copyCompiledStages(compiled);
+    }
+
+    Cascade::GainSpread::GainSpread(const Cascade& cascade, double range)
+        : m_cascade(cascade)
+        , m_range(range)
+        , m_stage(0)
+        , m_numPoints(0)
+        , m_scale(1)
+    {
+        for (int i = 0; i < gridPoints; ++i)
+            m_z[m_numPoints++] = std::polar(1., -doublePi * i / (gridPoints - 1));
+
+        // a resonant stage peaks near the angle of its poles
+        const BiquadCoefficients<double>* stage = cascade.m_compiledArray;
+        for (int i = cascade.m_numStages; --i >= 0 && m_numPoints < maxPoints; ++stage)
+            if (stage->a2 > 0 && stage->a1 * stage->a1 < 4 * stage->a2)
+            {
+                const double c = -stage->a1 / (2 * std::sqrt(stage->a2));
+                m_z[m_numPoints++] = std::polar(1.,
+                    -std::acos(std::max(-1., std::min(1., c))));
+            }
+
+        std::fill(m_response, m_response + m_numPoints, complex_t(1));
+    }
+
+    double Cascade::GainSpread::next()
+    {
+        // the last stage restores the gain of the design
+        const int index = m_stage++;
+        if (index == m_cascade.m_numStages - 1)
+            return 1 / m_scale;
+
+        const BiquadCoefficients<double>& c = m_cascade.m_compiledArray[index];
+        double peak = 0;
+        for (int i = 0; i < m_numPoints; ++i)
+        {
+            const complex_t z = m_z[i];
+            m_response[i] *= (c.b0 + (c.b1 + c.b2 * z) * z)
+                / (1. + (c.a1 + c.a2 * z) * z);
+            peak = std::max(peak, std::abs(m_response[i]));
+        }
+
+        // Without a finite peak the stage keeps its gain. The stages after
+        // this one must still be able to restore the gain of the design.
+        double lowest = 1;
+        for (int i = index + 1; i < m_cascade.m_numStages; ++i)
+            lowest /= getLimit(i);
+
+        const double target = std::min(std::max(
+            peak > 0 && peak <= DBL_MAX ? 1 / peak : m_scale, lowest),
+            m_scale * getLimit(index));
+
+        const double scale = target / m_scale;
+        m_scale = target;
+        return scale;
+    }
+
+    double Cascade::GainSpread::getLimit(int index) const
+    {
+        const BiquadCoefficients<double>& c = m_cascade.m_compiledArray[index];
+        const double largest = std::max(std::max(std::abs(c.b0),
+            std::abs(c.b1)), std::abs(c.b2));
+        return largest > 0 ? m_range / largest : DBL_MAX;
+    }
+
 }
 
 
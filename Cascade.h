@@ -18,17 +18,23 @@ namespace Dsp {
     class Cascade
     {
     public:
-        template <class StateType>
-        class StateBase : private DenormalPrevention
+        template <class StateType, class Denormal = DenormalPrevention>
+        class StateBase : private Denormal
         {
         public:
+            typedef StateType state_type_t;
+            typedef Denormal denormal_t;
+
             template <typename Sample>
             inline Sample process(const Sample in, const Cascade& c)
             {
+                typedef typename StateType::value_type value_type;
+
                 double out = in;
                 StateType* state = m_stateArray;
-                Biquad const* stage = c.m_stageArray;
-                const double vsa = ac();
+                const BiquadCoefficients<value_type>* stage =
+                    c.getCompiledStages<value_type>();
+                const double vsa = this->ac();
                 int i = c.m_numStages - 1;
                 out = (state++)->process1(out, *stage++, vsa);
                 for (; --i >= 0;)
@@ -38,6 +44,116 @@ namespace Dsp {
                 return static_cast<Sample> (out);
             }
 
+            // Process a block of samples
+            template <typename Sample>
+            void process(int numSamples, Sample* dest, const Cascade& c)
+            {
+                typename Denormal::Scope scope;
+                while (--numSamples >= 0) {
+                    *dest = process(*dest, c);
+                    dest++;
+                }
+            }
+
+            // Process a block of samples out of place
+            template <typename Source, typename Sample>
+            void process(int numSamples,
+                const Source* src,
+                Sample* dest,
+                const Cascade& c)
+            {
+                typename Denormal::Scope scope;
+                while (--numSamples >= 0)
+                    *dest++ = process(static_cast<Sample>(*src++), c);
+            }
+
+            // Process a block of samples for several channels at once
+            template <class ChannelState, typename Sample>
+            static void process(int numSamples,
+                int numChannels,
+                Sample* const* arrayOfChannels,
+                ChannelState* stateArray,
+                const Cascade& c)
+            {
+                typedef typename StateType::value_type value_type;
+
+                typename Denormal::Scope scope;
+                processChannels(numSamples, numChannels, arrayOfChannels,
+                    stateArray, c.m_numStages,
+                    c.getCompiledStages<value_type>());
+            }
+
+            // Process several channels out of place
+            template <class ChannelState, typename Source, typename Sample>
+            static void process(int numSamples,
+                int numChannels,
+                const Source* const* sourceChannels,
+                Sample* const* arrayOfChannels,
+                ChannelState* stateArray,
+                const Cascade& c)
+            {
+                typedef typename StateType::value_type value_type;
+
+                typename Denormal::Scope scope;
+                processChannels(numSamples, numChannels, sourceChannels,
+                    arrayOfChannels, stateArray, c.m_numStages,
+                    c.getCompiledStages<value_type>());
+            }
+
+            // Process interleaved frames for several channels at once
+            template <class ChannelState, typename Sample>
+            static void process(int numSamples,
+                int numChannels,
+                Sample* frames,
+                int frameStride,
+                ChannelState* stateArray,
+                const Cascade& c)
+            {
+                typedef typename StateType::value_type value_type;
+
+                typename Denormal::Scope scope;
+                processFrames(numSamples, numChannels, frames, frameStride,
+                    stateArray, c.m_numStages,
+                    c.getCompiledStages<value_type>());
+            }
+
+            /*@Internal*/
+            // Process several channels out of place through stages that
+            // change every sample, see processChannelTrajectory
+            template <class ChannelState, typename Source, typename Sample>
+            static void processTrajectory(int numSamples,
+                int numChannels,
+                const Source* const* sourceChannels,
+                Sample* const* arrayOfChannels,
+                ChannelState* stateArray,
+                int numStages,
+                const BiquadCoefficients<typename StateType::value_type>* trajectory,
+                int stride)
+            {
+                typename Denormal::Scope scope;
+                processChannelTrajectory(numSamples, numChannels,
+                    sourceChannels, arrayOfChannels, stateArray, numStages,
+                    trajectory, stride);
+            }
+
+            // Number of samples by which the output lags the input
+            static int getLatency(const Cascade&)
+            {
+                return 0;
+            }
+
+            /*@Internal*/
+            StateType* getStateArray()
+            {
+                return m_stateArray;
+            }
+
+            /*@Internal*/
+            DenormalPrevention& getDenormalPrevention()
+            {
+                return *this;
+            }
+
         protected:
             StateBase(StateType* stateArray)
                 : m_stateArray(stateArray)
@@ -52,16 +168,31 @@ namespace Dsp {
         {
         };
 
+        // Room for one compiled section in any of the narrow precisions
+        union NarrowStage
+        {
+            char f[sizeof(BiquadCoefficients<float>)];
+            char q15[sizeof(BiquadCoefficients<int16_t>)];
+            char q31[sizeof(BiquadCoefficients<int32_t>)];
+        };
+
         struct Storage
         {
-            Storage(int maxStages_, Stage* stageArray_)
+            Storage(int maxStages_,
+                Stage* stageArray_,
+                BiquadCoefficients<double>* compiledArray_,
+                NarrowStage* compiledNarrowArray_)
                 : maxStages(maxStages_)
                 , stageArray(stageArray_)
+                , compiledArray(compiledArray_)
+                , compiledNarrowArray(compiledNarrowArray_)
             {
             }
 
             int maxStages;
             Stage* stageArray;
+            BiquadCoefficients<double>* compiledArray;
+            NarrowStage* compiledNarrowArray;
         };
 
         int getNumStages() const
@@ -69,26 +200,147 @@ namespace Dsp {
             return m_numStages;
         }
 
-        const Stage& operator[] (int index)
+        const Stage& operator[] (int index) const
         {
             assert(index >= 0 && index <= m_numStages);
             return m_stageArray[index];
         }
 
+        // The coefficients of the stages as the processing loops read them,
+        // kept up to date with the stages. Value is double or float, or
+        // int16_t and int32_t for the fixed point forms.
+        template <typename Value>
+        const BiquadCoefficients<Value>* getCompiledStages() const;
+
+        // Put the stages into stages as the state forms of Value read
+        // them, whichever narrow value type is compiled, for containers
+        // that keep their own copies such as StreamPool. The fixed point
+        // forms get the gain of the design spread over the stages, see
+        // GainSpread. Returns the number of coefficients lost to rounding.
+        template <typename Value>
+        int copyCompiledStages(BiquadCoefficients<Value>* stages) const;
+
+        // The number of coefficients that are not zero in the design but
+        // round to zero in the compiled stages of Value. Only the fixed
+        // point forms can lose coefficients, see DirectFormIQ15.
+        template <typename Value>
+        int getLostCoefficients() const;
+
+        // Compile the stages for state forms of Value from now on. Double
+        // is always compiled; of float, int16_t and int32_t only one is
+        // kept at a time, float unless set here. SimpleFilter and the
+        // FilterDesign classes set the value type of their state form.
+        template <typename Value>
+        void setCompiledValueType();
+
     public:
         // Calculate filter response at the given normalized frequency.
         complex_t response(double normalizedFrequency) const;
 
+        // Calculate the response at each of numFrequencies normalized
+        // frequencies, many at a time in SIMD lanes. The results agree with
+        // response() to within rounding.
+        void responseGrid(const double* normalizedFrequencies,
+            int numFrequencies,
+            complex_t* response) const;
+
+        // The same at numFrequencies points from first to last, both
+        // included, with linear or logarithmic spacing. The points are
+        // reached by complex rotations, without computing cos and sin of
+        // each frequency.
+        void responseGrid(double first,
+            double last,
+            int numFrequencies,
+            Spacing spacing,
+            complex_t* response) const;
+
+        // The magnitude of the response in decibels
+        void magnitudeDbGrid(const double* normalizedFrequencies,
+            int numFrequencies,
+            double* magnitudeDb) const;
+
+        void magnitudeDbGrid(double first,
+            double last,
+            int numFrequencies,
+            Spacing spacing,
+            double* magnitudeDb) const;
+
         std::vector<PoleZeroPair> getPoleZeros() const;
 
+        // Copy up to maxPairs pole/zero pairs into pairs without allocating
+        // memory, and return how many pairs there are in all
+        int getPoleZeros(PoleZeroPair* pairs, int maxPairs) const;
+
         // Process a block of samples in the given form
         template <class StateType, typename Sample>
         void process(int numSamples, Sample* dest, StateType& state) const
         {
-            while (--numSamples >= 0) {
-                *dest = state.process(*dest, *this);
-                dest++;
-            }
+            state.process(numSamples, dest, *this);
+        }
+
+        // Process a block of samples out of place, converting from the
+        // source sample type, for example int16 or float into double. The
+        // output is identical to copying src to dest and processing dest.
+        template <class StateType, typename Source, typename Sample>
+        void process(int numSamples,
+            const Source* src,
+            Sample* dest,
+            StateType& state) const
+        {
+            state.process(numSamples, src, dest, *this);
+        }
+
+        // Process a block of samples in the given form, one stage at a time
+        // instead of one sample at a time. Long cascades processed in large
+        // blocks benefit the most. The output is identical to process().
+        template <class StateType, typename Sample>
+        void processByStage(int numSamples, Sample* dest, StateType& state) const
+        {
+            typedef typename StateType::state_type_t::value_type value_type;
+
+            typename StateType::denormal_t::Scope scope;
+            processStages(numSamples, m_numStages,
+                getCompiledStages<value_type>(), dest,
+                state.getStateArray(), state.getDenormalPrevention());
+        }
+
+        // Process a block of samples for several channels, running groups
+        // of channels through each stage in parallel SIMD lanes. The output
+        // is identical to processing each channel in turn.
+        template <class ChannelState, typename Sample>
+        void process(int numSamples,
+            int numChannels,
+            Sample* const* arrayOfChannels,
+            ChannelState* stateArray) const
+        {
+            ChannelState::process(numSamples, numChannels,
+                arrayOfChannels, stateArray, *this);
+        }
+
+        // Process several channels out of place, see above
+        template <class ChannelState, typename Source, typename Sample>
+        void process(int numSamples,
+            int numChannels,
+            const Source* const* sourceChannels,
+            Sample* const* arrayOfChannels,
+            ChannelState* stateArray) const
+        {
+            ChannelState::process(numSamples, numChannels,
+                sourceChannels, arrayOfChannels, stateArray, *this);
+        }
+
+        // Process interleaved frames in place, sample n of channel i being
+        // frames[n * frameStride + i]. The output is identical to the
+        // planar version.
+        template <class ChannelState, typename Sample>
+        void process(int numSamples,
+            int numChannels,
+            Sample* frames,
+            int frameStride,
+            ChannelState* stateArray) const
+        {
+            ChannelState::process(numSamples, numChannels,
+                frames, frameStride, stateArray, *this);
         }
 
     protected:
@@ -99,10 +351,746 @@ namespace Dsp {
         void applyScale(double scale);
         void setLayout(const LayoutBase& proto);
 
+        // Copy in the stages of an earlier design
+        void setStages(int numStages, const Stage* stages);
+
+    public:
+        /*@Internal*/
+        // Put the compiled stages of Value of from, moved a fraction t of
+        // the way to those of to, into stages, as many as to has. At t = 1,
+        // or if from has a different number of stages, they are an exact
+        // copy of those of to. For the coefficient ramps of
+        // SmoothedFilterDesign.
+        template <typename Value>
+        static void interpolate(const Cascade& from,
+            const Cascade& to,
+            double t,
+            BiquadCoefficients<Value>* stages);
+
+    private:
+        // The value types the narrow compiled array can hold
+        enum NarrowValue
+        {
+            narrowFloat,
+            narrowQ15,
+            narrowQ31
+        };
+
+        template <typename Value>
+        struct Narrow;
+
+        // Spreads the gain of the design, which the first stage carries,
+        // over the stages for the fixed point forms, where it would round
+        // away. next() returns the factor for the feedforward coefficients
+        // of each stage in turn, so that the output of every stage but the
+        // last peaks at unit gain and the last restores the gain of the
+        // design. No coefficient is scaled past range, so where the stages
+        // after it could not make up for a smaller gain a stage keeps more.
+        // Peaks are taken over a grid of frequencies and the pole angles of
+        // the stages.
+        class GainSpread
+        {
+        public:
+            GainSpread(const Cascade& cascade, double range);
+
+            double next();
+
+        private:
+            // The largest factor the feedforward coefficients of a stage take
+            double getLimit(int index) const;
+
+        private:
+            enum
+            {
+                gridPoints = 64,
+                maxPoints = 128
+            };
+
+            const Cascade& m_cascade;
+            double m_range;
+            int m_stage;
+            int m_numPoints;
+            double m_scale;                 // product of the factors so far
+            complex_t m_z[maxPoints];       // e^-jw at each point
+            complex_t m_response[maxPoints];
+        };
+
+        // Refreshes the compiled coefficients from the stages
+        void compileStages();
+
+        template <typename Value>
+        void compileNarrowStages();
+
+        template <typename Value>
+        const BiquadCoefficients<Value>* getNarrowStages() const
+        {
+            assert(m_narrowValue == Narrow<Value>::value);
+            return reinterpret_cast<const BiquadCoefficients<Value>*>(
+                m_compiledNarrowArray);
+        }
+
+        // Stage i as the coefficient ramps of Value start from
+        template <typename Value>
+        BiquadCoefficients<double> getRampStage(int i) const
+        {
+            return m_compiledArray[i];
+        }
+
     private:
         int m_numStages;
         int m_maxStages;
         Stage* m_stageArray;
+        BiquadCoefficients<double>* m_compiledArray;
+        NarrowStage* m_compiledNarrowArray;
+        NarrowValue m_narrowValue;
+        int m_lostCoefficients;
+    };
+
+    template <>
+    struct Cascade::Narrow <float>
+    {
+        static const NarrowValue value = narrowFloat;
+    };
+
+    template <>
+    struct Cascade::Narrow <int16_t>
+    {
+        static const NarrowValue value = narrowQ15;
+    };
+
+    template <>
+    struct Cascade::Narrow <int32_t>
+    {
+        static const NarrowValue value = narrowQ31;
+    };
+
+    template <>
+    inline const BiquadCoefficients<double>* Cascade::getCompiledStages<double>() const
+    {
+        return m_compiledArray;
+    }
+
+    template <typename Value>
+    inline const BiquadCoefficients<Value>* Cascade::getCompiledStages() const
+    {
+        return getNarrowStages<Value>();
+    }
+
+    template <typename Value>
+    int Cascade::copyCompiledStages(BiquadCoefficients<Value>* stages) const
+    {
+        int lost = 0;
+        if (!std::numeric_limits<Value>::is_integer)
+        {
+            for (int i = 0; i < m_numStages; ++i)
+            {
+                stages[i] = roundCoefficients<Value>(m_compiledArray[i]);
+                lost += countLostCoefficients(m_compiledArray[i], stages[i]);
+            }
+            return lost;
+        }
+
+        // the largest coefficient of Value, just under 2
+        const double range = std::ldexp(double(std::numeric_limits<Value>::max()),
+            1 - std::numeric_limits<Value>::digits);
+
+        GainSpread gains(*this, range);
+        for (int i = 0; i < m_numStages; ++i)
+        {
+            BiquadCoefficients<double> c = m_compiledArray[i];
+            const double scale = gains.next();
+            c.b0 *= scale;
+            c.b1 *= scale;
+            c.b2 *= scale;
+            stages[i] = roundCoefficients<Value>(c);
+            lost += countLostCoefficients(c, stages[i]);
+        }
+        return lost;
+    }
+
+    template <typename Value>
+    int Cascade::getLostCoefficients() const
+    {
+        assert(m_narrowValue == Narrow<Value>::value);
+        return m_lostCoefficients;
+    }
+
+    template <>
+    inline int Cascade::getLostCoefficients<double>() const
+    {
+        return 0;
+    }
+
+    // The fixed point forms ramp between the spread stages they process
+    template <>
+    inline BiquadCoefficients<double> Cascade::getRampStage<int16_t>(int i) const
+    {
+        return widenCoefficients(getNarrowStages<int16_t>()[i], 14);
+    }
+
+    template <>
+    inline BiquadCoefficients<double> Cascade::getRampStage<int32_t>(int i) const
+    {
+        return widenCoefficients(getNarrowStages<int32_t>()[i], 30);
+    }
+
+    template <typename Value>
+    void Cascade::setCompiledValueType()
+    {
+        if (m_narrowValue != Narrow<Value>::value)
+        {
+            m_narrowValue = Narrow<Value>::value;
+            compileStages();
+        }
+    }
+
+    template <>
+    inline void Cascade::setCompiledValueType<double>()
+    {
+    }
+
+    template <typename Value>
+    void compileStagesFor(Cascade* design)
+    {
+        design->setCompiledValueType<Value>();
+    }
+
+    template <typename Value>
+    void Cascade::interpolate(const Cascade& from,
+        const Cascade& to,
+        double t,
+        BiquadCoefficients<Value>* stages)
+    {
+        const int numStages = to.m_numStages;
+        if (t >= 1 || from.m_numStages != numStages)
+        {
+            const BiquadCoefficients<Value>* target = to.getCompiledStages<Value>();
+            std::copy(target, target + numStages, stages);
+            return;
+        }
+
+        for (int i = 0; i < numStages; ++i)
+            stages[i] = roundCoefficients<Value>(interpolateCoefficients(
+                from.getRampStage<Value>(i), to.getRampStage<Value>(i), t));
+    }
+
+    // Kernels see the compiled stages in the precision of their form
+    template <>
+    struct Dispatch::StageIndex <BiquadCoefficients<double> >
+    {
+        enum { value = 1 };
+    };
+
+    template <>
+    struct Dispatch::StageIndex <BiquadCoefficients<float> >
+    {
+        enum { value = 1 };
+    };
+
+    //------------------------------------------------------------------------------
+
+    // State for running the stages of a Cascade as a skewed SIMD pipeline.
+    // The output is delayed by getLatency() samples, see SkewedDirectFormII.
+    template <class Denormal>
+    class Cascade::StateBase <SkewedDirectFormII, Denormal> : private Denormal
+    {
+    public:
+        typedef SkewedDirectFormII state_type_t;
+        typedef Denormal denormal_t;
+
+        template <typename Sample>
+        inline Sample process(const Sample in, const Cascade& c)
+        {
+            return static_cast<Sample> (SkewedDirectFormII::process(in,
+                c.m_numStages, c.getCompiledStages<double>(), m_stateArray,
+                this->ac()));
+        }
+
+        // Process a block of samples
+        template <typename Sample>
+        void process(int numSamples, Sample* dest, const Cascade& c)
+        {
+            typename Denormal::Scope scope;
+            if (!Dispatch::processSkewed(numSamples, dest,
+                c.m_numStages, c.getCompiledStages<double>(), m_stateArray,
+                *this))
+            {
+                while (--numSamples >= 0) {
+                    *dest = process(*dest, c);
+                    dest++;
+                }
+            }
+        }
+
+        // The pipeline works in place, so the source goes through dest
+        template <typename Source, typename Sample>
+        void process(int numSamples,
+            const Source* src,
+            Sample* dest,
+            const Cascade& c)
+        {
+            processFrom(numSamples, src, dest, *this, c);
+        }
+
+
+        // The stages of one channel already fill the vector
+        // registers, so channels are processed one at a time.
+        template <class ChannelState, typename Sample>
+        static void process(int numSamples,
+            int numChannels,
+            Sample* const* arrayOfChannels,
+            ChannelState* stateArray,
+            const Cascade& c)
+        {
+            for (int i = 0; i < numChannels; ++i)
+                stateArray[i].process(numSamples, arrayOfChannels[i], c);
+        }
+
+        template <class ChannelState, typename Source, typename Sample>
+        static void process(int numSamples,
+            int numChannels,
+            const Source* const* sourceChannels,
+            Sample* const* arrayOfChannels,
+            ChannelState* stateArray,
+            const Cascade& c)
+        {
+            for (int i = 0; i < numChannels; ++i)
+                stateArray[i].process(numSamples, sourceChannels[i],
+                    arrayOfChannels[i], c);
+        }
+
+        template <class ChannelState, typename Sample>
+        static void process(int numSamples,
+            int numChannels,
+            Sample* frames,
+            int frameStride,
+            ChannelState* stateArray,
+            const Cascade& c)
+        {
+            processFramesByChannel(numSamples, numChannels, frames,
+                frameStride, stateArray, c);
+        }
+
+        /*@Internal*/
+        // Process a block of samples stride apart through stages that
+        // change every sample, see processChannelTrajectory
+        template <typename Source, typename Sample>
+        void processTrajectory(int numSamples,
+            const Source* src,
+            Sample* dest,
+            int numStages,
+            const BiquadCoefficients<double>* trajectory,
+            int stride)
+        {
+            typename Denormal::Scope scope;
+            for (; --numSamples >= 0; src += stride, dest += stride)
+            {
+                *dest = static_cast<Sample> (SkewedDirectFormII::process(
+                    static_cast<Sample>(*src), numStages, trajectory,
+                    m_stateArray, this->ac()));
+                trajectory += numStages;
+            }
+        }
+
+        /*@Internal*/
+        template <class ChannelState, typename Source, typename Sample>
+        static void processTrajectory(int numSamples,
+            int numChannels,
+            const Source* const* sourceChannels,
+            Sample* const* arrayOfChannels,
+            ChannelState* stateArray,
+            int numStages,
+            const BiquadCoefficients<double>* trajectory,
+            int stride)
+        {
+            for (int i = 0; i < numChannels; ++i)
+                stateArray[i].processTrajectory(numSamples, sourceChannels[i],
+                    arrayOfChannels[i], numStages, trajectory, stride);
+        }
+
+        // Number of samples by which the output lags the input
+        static int getLatency(const Cascade& c)
+        {
+            return std::max(c.getNumStages() - 1, 0);
+        }
+
+    protected:
+        StateBase(SkewedDirectFormII* stateArray)
+            : m_stateArray(stateArray)
+        {
+        }
+
+    protected:
+        SkewedDirectFormII* m_stateArray;
+    };
+
+    //------------------------------------------------------------------------------
+
+    // State for running each stage of a Cascade over a block of samples
+    // K samples at a time, see BlockStateSpace.
+    template <int K, class Denormal>
+    class Cascade::StateBase <BlockStateSpace <K>, Denormal> : private Denormal
+    {
+    public:
+        typedef BlockStateSpace <K> state_type_t;
+        typedef Denormal denormal_t;
+
+        template <typename Sample>
+        inline Sample process(const Sample in, const Cascade& c)
+        {
+            double out = in;
+            BlockStateSpace <K>* state = m_stateArray;
+            const BiquadCoefficients<double>* stage =
+                c.getCompiledStages<double>();
+            const double vsa = this->ac();
+            int i = c.m_numStages - 1;
+            out = (state++)->process1(out, *stage++, vsa);
+            for (; --i >= 0;)
+                out = (state++)->process1(out, *stage++, 0);
+            return static_cast<Sample> (out);
+        }
+
+        // Process a block of samples
+        template <typename Sample>
+        void process(int numSamples, Sample* dest, const Cascade& c)
+        {
+            process(numSamples, dest, dest, c);
+        }
+
+        // Process a block of samples out of place
+        template <typename Source, typename Sample>
+        void process(int numSamples,
+            const Source* src,
+            Sample* dest,
+            const Cascade& c)
+        {
+            typename Denormal::Scope scope;
+
+            const int chunkSamples = 256;
+            double data[chunkSamples];
+
+            double vsa = this->getAc();
+            while (numSamples > 0)
+            {
+                const int count = std::min(numSamples, chunkSamples);
+
+                for (int n = 0; n < count; ++n)
+                    data[n] = static_cast<Sample> (src[n]);
+
+                for (int k = 0; k < c.m_numStages; ++k)
+                {
+                    double zero = 0;
+                    m_stateArray[k].process(count, data,
+                        c.m_stageArray[k], k == 0 ? vsa : zero);
+                }
+
+                for (int n = 0; n < count; ++n)
+                    dest[n] = static_cast<Sample> (data[n]);
+
+                src += count;
+                dest += count;
+                numSamples -= count;
+            }
+            this->setAc(vsa);
+        }
+
+        // Each channel runs its own blocks, one channel at a time.
+        template <class ChannelState, typename Sample>
+        static void process(int numSamples,
+            int numChannels,
+            Sample* const* arrayOfChannels,
+            ChannelState* stateArray,
+            const Cascade& c)
+        {
+            for (int i = 0; i < numChannels; ++i)
+                stateArray[i].process(numSamples, arrayOfChannels[i], c);
+        }
+
+        template <class ChannelState, typename Source, typename Sample>
+        static void process(int numSamples,
+            int numChannels,
+            const Source* const* sourceChannels,
+            Sample* const* arrayOfChannels,
+            ChannelState* stateArray,
+            const Cascade& c)
+        {
+            for (int i = 0; i < numChannels; ++i)
+                stateArray[i].process(numSamples, sourceChannels[i],
+                    arrayOfChannels[i], c);
+        }
+
+        template <class ChannelState, typename Sample>
+        static void process(int numSamples,
+            int numChannels,
+            Sample* frames,
+            int frameStride,
+            ChannelState* stateArray,
+            const Cascade& c)
+        {
+            processFramesByChannel(numSamples, numChannels, frames,
+                frameStride, stateArray, c);
+        }
+
+        /*@Internal*/
+        // Process a block of samples stride apart through stages that
+        // change every sample, see processChannelTrajectory
+        template <typename Source, typename Sample>
+        void processTrajectory(int numSamples,
+            const Source* src,
+            Sample* dest,
+            int numStages,
+            const BiquadCoefficients<double>* trajectory,
+            int stride)
+        {
+            typename Denormal::Scope scope;
+            for (; --numSamples >= 0; src += stride, dest += stride)
+            {
+                double out = static_cast<Sample>(*src);
+                BlockStateSpace <K>* state = m_stateArray;
+                const double vsa = this->ac();
+                int i = numStages - 1;
+                out = (state++)->process1(out, *trajectory++, vsa);
+                for (; --i >= 0;)
+                    out = (state++)->process1(out, *trajectory++, 0);
+                *dest = static_cast<Sample> (out);
+            }
+        }
+
+        /*@Internal*/
+        template <class ChannelState, typename Source, typename Sample>
+        static void processTrajectory(int numSamples,
+            int numChannels,
+            const Source* const* sourceChannels,
+            Sample* const* arrayOfChannels,
+            ChannelState* stateArray,
+            int numStages,
+            const BiquadCoefficients<double>* trajectory,
+            int stride)
+        {
+            for (int i = 0; i < numChannels; ++i)
+                stateArray[i].processTrajectory(numSamples, sourceChannels[i],
+                    arrayOfChannels[i], numStages, trajectory, stride);
+        }
+
+        // Number of samples by which the output lags the input
+        static int getLatency(const Cascade&)
+        {
+            return 0;
+        }
+
+        /*@Internal*/
+        BlockStateSpace <K>* getStateArray()
+        {
+            return m_stateArray;
+        }
+
+        /*@Internal*/
+        DenormalPrevention& getDenormalPrevention()
+        {
+            return *this;
+        }
+
+    protected:
+        StateBase(BlockStateSpace <K>* stateArray)
+            : m_stateArray(stateArray)
+        {
+        }
+
+    protected:
+        BlockStateSpace <K>* m_stateArray;
+    };
+
+    //------------------------------------------------------------------------------
+
+    // State for a Cascade with a stage count fixed at compile time, see
+    // FixedStages. The states of the sections are members, not an array
+    // supplied by the storage class.
+    template <int Stages, class Form, class Denormal>
+    class Cascade::StateBase <FixedStages <Stages, Form>, Denormal> : private Denormal
+    {
+    public:
+        typedef Form state_type_t;
+        typedef Denormal denormal_t;
+
+        template <typename Sample>
+        inline Sample process(const Sample in, const Cascade& c)
+        {
+            typedef typename Form::value_type value_type;
+
+            assert(c.m_numStages == Stages);
+
+            const BiquadCoefficients<value_type>* stage =
+                c.getCompiledStages<value_type>();
+            double out = in;
+            out = m_states[0].process1(out, stage[0], this->ac());
+            for (int k = 1; k < Stages; ++k)
+                out = m_states[k].process1(out, stage[k], 0);
+            return static_cast<Sample> (out);
+        }
+
+        // Process a block of samples. The coefficients and states of all
+        // stages are held in registers for a chunk of samples at a time.
+        template <typename Sample>
+        void process(int numSamples, Sample* dest, const Cascade& c)
+        {
+            process(numSamples, dest, dest, c);
+        }
+
+        // Process a block of samples out of place
+        template <typename Source, typename Sample>
+        void process(int numSamples,
+            const Source* src,
+            Sample* dest,
+            const Cascade& c)
+        {
+            typedef typename Form::value_type value_type;
+
+            assert(c.m_numStages == Stages);
+
+            typename Denormal::Scope scope;
+
+            const int chunkSamples = 256;
+            value_type data[chunkSamples];
+
+            value_type vsa = static_cast<value_type>(this->getAc());
+            while (numSamples > 0)
+            {
+                const int count = std::min(numSamples, chunkSamples);
+
+                for (int n = 0; n < count; ++n)
+                    data[n] = static_cast<value_type>(static_cast<Sample>(src[n]));
+
+                processStageGroup<Stages>(count, data,
+                    c.getCompiledStages<value_type>(), m_states,
+                    vsa, value_type(-1));
+
+                for (int n = 0; n < count; ++n)
+                    dest[n] = static_cast<Sample> (data[n]);
+
+                src += count;
+                dest += count;
+                numSamples -= count;
+            }
+            this->setAc(vsa);
+        }
+
+        // Process a block of samples for several channels at once
+        template <class ChannelState, typename Sample>
+        static void process(int numSamples,
+            int numChannels,
+            Sample* const* arrayOfChannels,
+            ChannelState* stateArray,
+            const Cascade& c)
+        {
+            // a lone channel is faster with the stages unrolled
+            if (numChannels == 1)
+            {
+                stateArray[0].process(numSamples, arrayOfChannels[0], c);
+                return;
+            }
+
+            typedef typename Form::value_type value_type;
+
+            assert(c.m_numStages == Stages);
+
+            typename Denormal::Scope scope;
+            processChannels(numSamples, numChannels, arrayOfChannels,
+                stateArray, int(Stages), c.getCompiledStages<value_type>());
+        }
+
+        // Process several channels out of place
+        template <class ChannelState, typename Source, typename Sample>
+        static void process(int numSamples,
+            int numChannels,
+            const Source* const* sourceChannels,
+            Sample* const* arrayOfChannels,
+            ChannelState* stateArray,
+            const Cascade& c)
+        {
+            if (numChannels == 1)
+            {
+                stateArray[0].process(numSamples, sourceChannels[0],
+                    arrayOfChannels[0], c);
+                return;
+            }
+
+            typedef typename Form::value_type value_type;
+
+            assert(c.m_numStages == Stages);
+
+            typename Denormal::Scope scope;
+            processChannels(numSamples, numChannels, sourceChannels,
+                arrayOfChannels, stateArray, int(Stages),
+                c.getCompiledStages<value_type>());
+        }
+
+        // Process interleaved frames for several channels at once
+        template <class ChannelState, typename Sample>
+        static void process(int numSamples,
+            int numChannels,
+            Sample* frames,
+            int frameStride,
+            ChannelState* stateArray,
+            const Cascade& c)
+        {
+            typedef typename Form::value_type value_type;
+
+            assert(c.m_numStages == Stages);
+
+            typename Denormal::Scope scope;
+            processFrames(numSamples, numChannels, frames, frameStride,
+                stateArray, int(Stages), c.getCompiledStages<value_type>());
+        }
+
+        /*@Internal*/
+        template <class ChannelState, typename Source, typename Sample>
+        static void processTrajectory(int numSamples,
+            int numChannels,
+            const Source* const* sourceChannels,
+            Sample* const* arrayOfChannels,
+            ChannelState* stateArray,
+            int numStages,
+            const BiquadCoefficients<typename Form::value_type>* trajectory,
+            int stride)
+        {
+            assert(numStages == Stages);
+
+            typename Denormal::Scope scope;
+            processChannelTrajectory(numSamples, numChannels, sourceChannels,
+                arrayOfChannels, stateArray, int(Stages), trajectory, stride);
+        }
+
+        // Number of samples by which the output lags the input
+        static int getLatency(const Cascade&)
+        {
+            return 0;
+        }
+
+        void reset()
+        {
+            for (int k = 0; k < Stages; ++k)
+                m_states[k].reset();
+        }
+
+        /*@Internal*/
+        Form* getStateArray()
+        {
+            return m_states;
+        }
+
+        /*@Internal*/
+        DenormalPrevention& getDenormalPrevention()
+        {
+            return *this;
+        }
+
+    protected:
+        StateBase()
+        {
+        }
+
+    private:
+        Form m_states[Stages];
     };
 
     //------------------------------------------------------------------------------
@@ -112,13 +1100,13 @@ namespace Dsp {
     class CascadeStages
     {
     public:
-        template <class StateType>
-        class State : public Cascade::StateBase <StateType>
+        template <class StateType, class Denormal = DenormalPrevention>
+        class State : public Cascade::StateBase <StateType, Denormal>
         {
         public:
-            State() : Cascade::StateBase <StateType>(m_states)
+            State() : Cascade::StateBase <StateType, Denormal>(m_states)
             {
-                Cascade::StateBase <StateType>::m_stateArray = m_states;
+                Cascade::StateBase <StateType, Denormal>::m_stateArray = m_states;
                 reset();
             }
 
@@ -133,14 +1121,32 @@ namespace Dsp {
             StateType m_states[MaxStages];
         };
 
+        // A fixed stage count keeps its states in Cascade::StateBase
+        template <int Stages, class Form, class Denormal>
+        class State <FixedStages <Stages, Form>, Denormal>
+            : public Cascade::StateBase <FixedStages <Stages, Form>, Denormal>
+        {
+        public:
+            State()
+            {
+                assert(Stages <= MaxStages);
+            }
+        };
+
         /*@Internal*/
         Cascade::Storage getCascadeStorage()
         {
-            return Cascade::Storage(MaxStages, m_stages);
+            return Cascade::Storage(MaxStages, m_stages,
+                m_compiled, m_compiledNarrow);
         }
 
     private:
         Cascade::Stage m_stages[MaxStages];
+
+        // Cache line aligned, so a short cascade touches as few lines
+        // as possible. Only one narrow precision is compiled at a time.
+        alignas(64) BiquadCoefficients<double> m_compiled[MaxStages];
+        alignas(64) Cascade::NarrowStage m_compiledNarrow[MaxStages];
     };
 
 }
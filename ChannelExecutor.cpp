@@ -0,0 +1,216 @@
+#include "pch.h"
+#include "Common.h"
+#include "ChannelExecutor.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#if defined(__linux__)
+#  include <pthread.h>
+#  include <sched.h>
+#endif
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#  include <emmintrin.h>
+#  define DSPFILTERS_CPU_RELAX() _mm_pause()
+#else
+#  define DSPFILTERS_CPU_RELAX() ((void)0)
+#endif
+
+namespace Dsp {
+
+    namespace {
+
+        // A thread checks for the next block this many times before it
+        // goes to sleep, some tens of microseconds.
+        const int spinCount = 4000;
+
+        // The tasks a thread starts on, kept on a cache line of its own
+        // so that claiming them does not slow down the other threads
+        struct Range
+        {
+            std::atomic<int> next;
+            int end;
+            char padding[64 - sizeof(std::atomic<int>) - sizeof(int)];
+        };
+
+    }
+
+    struct ChannelExecutor::Impl
+    {
+        explicit Impl(int numThreads_)
+            : numThreads(numThreads_)
+            , ranges(new Range[numThreads_])
+            , generation(0)
+            , pending(0)
+            , task(0)
+            , context(0)
+            , stop(false)
+        {
+        }
+
+        ~Impl()
+        {
+            delete[] ranges;
+        }
+
+        // Claim and run tasks, first from the thread's own range, then
+        // whatever is left in the others.
+        void work(int self)
+        {
+            for (int k = 0; k < numThreads; ++k)
+            {
+                Range& range = ranges[(self + k) % numThreads];
+                for (;;)
+                {
+                    const int index = range.next.fetch_add(1, std::memory_order_relaxed);
+                    if (index >= range.end)
+                        break;
+                    task(context, index);
+                }
+            }
+        }
+
+        void workerLoop(int self)
+        {
+            unsigned seen = 0;
+            for (;;)
+            {
+                int spins = 0;
+                while (generation.load(std::memory_order_acquire) == seen)
+                {
+                    if (++spins < spinCount)
+                    {
+                        DSPFILTERS_CPU_RELAX();
+                    }
+                    else
+                    {
+                        std::unique_lock<std::mutex> lock(mutex);
+                        while (generation.load(std::memory_order_acquire) == seen)
+                            wake.wait(lock);
+                    }
+                }
+
+                // run() waits for every worker before it starts the next
+                // block, so the generation moves on by exactly one
+                ++seen;
+                if (stop)
+                    return;
+
+                work(self);
+                pending.fetch_sub(1, std::memory_order_release);
+            }
+        }
+
+        int numThreads;
+        std::vector<std::thread> threads;
+        Range* ranges;
+
+        std::mutex mutex;
+        std::condition_variable wake;
+        std::atomic<unsigned> generation;
+        std::atomic<int> pending;
+
+        Task task;
+        void* context;
+        bool stop;
+    };
+
+    //------------------------------------------------------------------------------
+
+    ChannelExecutor::ChannelExecutor(int numThreads)
+    {
+        if (numThreads <= 0)
+            numThreads = std::max(1, int(std::thread::hardware_concurrency()));
+
+        m_impl = new Impl(numThreads);
+        for (int i = 1; i < numThreads; ++i)
+            m_impl->threads.push_back(std::thread(&Impl::workerLoop, m_impl, i));
+    }
+
+    ChannelExecutor::~ChannelExecutor()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_impl->mutex);
+            m_impl->stop = true;
+            m_impl->generation.fetch_add(1, std::memory_order_release);
+        }
+        m_impl->wake.notify_all();
+
+        for (size_t i = 0; i < m_impl->threads.size(); ++i)
+            m_impl->threads[i].join();
+
+        delete m_impl;
+    }
+
+    int ChannelExecutor::getNumThreads() const
+    {
+        return m_impl->numThreads;
+    }
+
+    bool ChannelExecutor::setAffinity(int thread, int processor)
+    {
+        assert(thread >= 1 && thread < m_impl->numThreads);
+        assert(processor >= 0);
+
+#if defined(_WIN32)
+        if (processor >= int(sizeof(DWORD_PTR) * 8))
+            return false;
+        HANDLE handle = static_cast<HANDLE>(m_impl->threads[thread - 1].native_handle());
+        return SetThreadAffinityMask(handle, DWORD_PTR(1) << processor) != 0;
+#elif defined(__linux__)
+        if (processor >= CPU_SETSIZE)
+            return false;
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(processor, &set);
+        return pthread_setaffinity_np(m_impl->threads[thread - 1].native_handle(),
+            sizeof(set), &set) == 0;
+#else
+        return false;
+#endif
+    }
+
+    void ChannelExecutor::run(int numTasks, Task task, void* context)
+    {
+        Impl& impl = *m_impl;
+        const int numThreads = impl.numThreads;
+
+        if (numThreads == 1 || numTasks <= 1)
+        {
+            for (int i = 0; i < numTasks; ++i)
+                task(context, i);
+            return;
+        }
+
+        impl.task = task;
+        impl.context = context;
+        for (int t = 0; t < numThreads; ++t)
+        {
+            impl.ranges[t].next.store(numTasks * t / numThreads, std::memory_order_relaxed);
+            impl.ranges[t].end = numTasks * (t + 1) / numThreads;
+        }
+        impl.pending.store(numThreads - 1, std::memory_order_relaxed);
+
+        {
+            std::lock_guard<std::mutex> lock(impl.mutex);
+            impl.generation.fetch_add(1, std::memory_order_release);
+        }
+        impl.wake.notify_all();
+
+        impl.work(0);
+
+        // A worker only checks in once the tasks it claimed are done
+        int spins = 0;
+        while (impl.pending.load(std::memory_order_acquire) != 0)
+        {
+            if (++spins < spinCount)
+                DSPFILTERS_CPU_RELAX();
+            else
+                std::this_thread::yield();
+        }
+    }
+
+}
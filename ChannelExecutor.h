@@ -0,0 +1,160 @@
+#ifndef DSPFILTERS_CHANNELEXECUTOR_H
+#define DSPFILTERS_CHANNELEXECUTOR_H
+
+#include "Common.h"
+
+namespace Dsp {
+
+    /*
+     * Runs the channels of a block on several threads.
+     *
+     * The executor owns a set of persistent worker threads. Each call to
+     * run() hands out a number of tasks, which start as one contiguous
+     * range per thread; a thread that finishes its own range steals what
+     * is left of the others, so uneven tasks still balance. The calling
+     * thread works on the first range and run() returns when every task
+     * is done.
+     *
+     * Between blocks the workers spin for a short while before going to
+     * sleep, so consecutive blocks of 64 to 512 samples find them awake.
+     *
+     * Attach an executor to a FilterDesign or SimpleFilter with
+     * setExecutor() to process its channels in parallel, in groups of
+     * channelsPerTask. It pays off for a hundred or more channels.
+     *
+     */
+    class ChannelExecutor
+    {
+    public:
+        typedef void(*Task)(void* context, int index);
+
+        enum
+        {
+            // Channels in one task, a multiple of every SIMD lane count
+            channelsPerTask = 16
+        };
+
+        // numThreads includes the calling thread, 0 for one per processor
+        explicit ChannelExecutor(int numThreads = 0);
+        ~ChannelExecutor();
+
+        int getNumThreads() const;
+
+        // Pin worker thread i (1 <= i < getNumThreads()) to a processor.
+        // The calling thread is never moved. Returns false where thread
+        // affinity is not supported.
+        bool setAffinity(int thread, int processor);
+
+        // Calls task(context, i) for every i in [0, numTasks) and returns
+        // when all of them are done.
+        void run(int numTasks, Task task, void* context);
+
+        template <class Function>
+        void run(int numTasks, Function& function)
+        {
+            run(numTasks, &invoke<Function>, &function);
+        }
+
+    private:
+        template <class Function>
+        static void invoke(void* context, int index)
+        {
+            (*static_cast<Function*>(context))(index);
+        }
+
+        ChannelExecutor(const ChannelExecutor&);
+        ChannelExecutor& operator= (const ChannelExecutor&);
+
+        struct Impl;
+        Impl* m_impl;
+    };
+
+    //------------------------------------------------------------------------------
+
+    /*@Internal*/
+    // Runs task(first, count) over numChannels channels in groups of
+    // channelsPerTask, on the executor if there is one and more than one
+    // group, otherwise in a single call on the calling thread.
+    template <class Task>
+    void runChannelGroups(ChannelExecutor* executor, int numChannels, Task& task)
+    {
+        struct Group
+        {
+            void operator() (int index)
+            {
+                const int first = index * ChannelExecutor::channelsPerTask;
+                (*task)(first, std::min(int(ChannelExecutor::channelsPerTask),
+                    numChannels - first));
+            }
+
+            Task* task;
+            int numChannels;
+        };
+
+        const int numGroups = (numChannels + ChannelExecutor::channelsPerTask - 1) /
+            ChannelExecutor::channelsPerTask;
+
+        if (executor && numGroups > 1)
+        {
+            Group group = { &task, numChannels };
+            executor->run(numGroups, group);
+        }
+        else
+        {
+            task(0, numChannels);
+        }
+    }
+
+    /*@Internal*/
+    // Tasks for runChannelGroups, one per ChannelsState::process overload
+
+    template <class Filter, class StateType, typename Sample>
+    struct ProcessChannelsTask
+    {
+        void operator() (int first, int count)
+        {
+            filter->process(numSamples, count, arrayOfChannels + first,
+                stateArray + first);
+        }
+
+        Filter* filter;
+        StateType* stateArray;
+        int numSamples;
+        Sample* const* arrayOfChannels;
+    };
+
+    template <class Filter, class StateType, typename Sample>
+    struct ProcessFramesTask
+    {
+        void operator() (int first, int count)
+        {
+            filter->process(numSamples, count, frames + first, frameStride,
+                stateArray + first);
+        }
+
+        Filter* filter;
+        StateType* stateArray;
+        int numSamples;
+        Sample* frames;
+        int frameStride;
+    };
+
+    template <class Filter, class StateType, typename Source, typename Sample>
+    struct ProcessFromTask
+    {
+        void operator() (int first, int count)
+        {
+            filter->process(numSamples, count, sourceChannels + first,
+                arrayOfChannels + first, stateArray + first);
+        }
+
+        Filter* filter;
+        StateType* stateArray;
+        int numSamples;
+        const Source* const* sourceChannels;
+        Sample* const* arrayOfChannels;
+    };
+
+}
+
+#endif
@@ -129,6 +129,11 @@ namespace Dsp {
             double cutoffFrequency,
             double rippleDb)
         {
+            const DesignCache::Key key(DesignCache::familyChebyshevI, kindLowPass, order,
+                cutoffFrequency / sampleRate, 0, 0, rippleDb);
+            if (DesignCache::load(key, *this))
+                return;
+
             m_analogProto.design(order, rippleDb);
 
             LowPassTransform(cutoffFrequency / sampleRate,
@@ -136,6 +141,8 @@ namespace Dsp {
                 m_analogProto);
 
             Cascade::setLayout(m_digitalProto);
+
+            DesignCache::store(key, *this);
         }
 
         void HighPassBase::setup(int order,
@@ -143,6 +150,11 @@ namespace Dsp {
             double cutoffFrequency,
             double rippleDb)
         {
+            const DesignCache::Key key(DesignCache::familyChebyshevI, kindHighPass, order,
+                cutoffFrequency / sampleRate, 0, 0, rippleDb);
+            if (DesignCache::load(key, *this))
+                return;
+
             m_analogProto.design(order, rippleDb);
 
             HighPassTransform(cutoffFrequency / sampleRate,
@@ -150,6 +162,8 @@ namespace Dsp {
                 m_analogProto);
 
             Cascade::setLayout(m_digitalProto);
+
+            DesignCache::store(key, *this);
         }
 
         void BandPassBase::setup(int order,
@@ -158,6 +172,12 @@ namespace Dsp {
             double widthFrequency,
             double rippleDb)
         {
+            const DesignCache::Key key(DesignCache::familyChebyshevI, kindBandPass, order,
+                centerFrequency / sampleRate, widthFrequency / sampleRate, 0,
+                rippleDb);
+            if (DesignCache::load(key, *this))
+                return;
+
             m_analogProto.design(order, rippleDb);
 
             BandPassTransform(centerFrequency / sampleRate,
@@ -166,6 +186,8 @@ namespace Dsp {
                 m_analogProto);
 
             Cascade::setLayout(m_digitalProto);
+
+            DesignCache::store(key, *this);
         }
 
         void BandStopBase::setup(int order,
@@ -174,6 +196,12 @@ namespace Dsp {
             double widthFrequency,
             double rippleDb)
         {
+            const DesignCache::Key key(DesignCache::familyChebyshevI, kindBandStop, order,
+                centerFrequency / sampleRate, widthFrequency / sampleRate, 0,
+                rippleDb);
+            if (DesignCache::load(key, *this))
+                return;
+
             m_analogProto.design(order, rippleDb);
 
             BandStopTransform(centerFrequency / sampleRate,
@@ -182,6 +210,8 @@ namespace Dsp {
                 m_analogProto);
 
             Cascade::setLayout(m_digitalProto);
+
+            DesignCache::store(key, *this);
         }
 
         void LowShelfBase::setup(int order,
@@ -190,6 +220,11 @@ namespace Dsp {
             double gainDb,
             double rippleDb)
         {
+            const DesignCache::Key key(DesignCache::familyChebyshevI, kindLowShelf, order,
+                cutoffFrequency / sampleRate, 0, gainDb, rippleDb);
+            if (DesignCache::load(key, *this))
+                return;
+
             m_analogProto.design(order, gainDb, rippleDb);
 
             LowPassTransform(cutoffFrequency / sampleRate,
@@ -197,6 +232,8 @@ namespace Dsp {
                 m_analogProto);
 
             Cascade::setLayout(m_digitalProto);
+
+            DesignCache::store(key, *this);
         }
 
         void HighShelfBase::setup(int order,
@@ -205,6 +242,11 @@ namespace Dsp {
             double gainDb,
             double rippleDb)
         {
+            const DesignCache::Key key(DesignCache::familyChebyshevI, kindHighShelf, order,
+                cutoffFrequency / sampleRate, 0, gainDb, rippleDb);
+            if (DesignCache::load(key, *this))
+                return;
+
             m_analogProto.design(order, gainDb, rippleDb);
 
             HighPassTransform(cutoffFrequency / sampleRate,
@@ -212,6 +254,8 @@ namespace Dsp {
                 m_analogProto);
 
             Cascade::setLayout(m_digitalProto);
+
+            DesignCache::store(key, *this);
         }
 
         void BandShelfBase::setup(int order,
@@ -221,6 +265,12 @@ namespace Dsp {
             double gainDb,
             double rippleDb)
         {
+            const DesignCache::Key key(DesignCache::familyChebyshevI, kindBandShelf, order,
+                centerFrequency / sampleRate, widthFrequency / sampleRate, gainDb,
+                rippleDb);
+            if (DesignCache::load(key, *this))
+                return;
+
             m_analogProto.design(order, gainDb, rippleDb);
 
             BandPassTransform(centerFrequency / sampleRate,
@@ -231,6 +281,8 @@ namespace Dsp {
             m_digitalProto.setNormal(((centerFrequency / sampleRate) < 0.25) ? doublePi : 0, 1);
 
             Cascade::setLayout(m_digitalProto);
+
+            DesignCache::store(key, *this);
         }
 
     }
@@ -128,6 +128,11 @@ namespace Dsp {
             double cutoffFrequency,
             double stopBandDb)
         {
+            const DesignCache::Key key(DesignCache::familyChebyshevII, kindLowPass, order,
+                cutoffFrequency / sampleRate, 0, 0, stopBandDb);
+            if (DesignCache::load(key, *this))
+                return;
+
             m_analogProto.design(order, stopBandDb);
 
             LowPassTransform(cutoffFrequency / sampleRate,
@@ -135,6 +140,8 @@ namespace Dsp {
                 m_analogProto);
 
             Cascade::setLayout(m_digitalProto);
+
+            DesignCache::store(key, *this);
         }
 
         void HighPassBase::setup(int order,
@@ -142,6 +149,11 @@ namespace Dsp {
             double cutoffFrequency,
             double stopBandDb)
         {
+            const DesignCache::Key key(DesignCache::familyChebyshevII, kindHighPass, order,
+                cutoffFrequency / sampleRate, 0, 0, stopBandDb);
+            if (DesignCache::load(key, *this))
+                return;
+
             m_analogProto.design(order, stopBandDb);
 
             HighPassTransform(cutoffFrequency / sampleRate,
@@ -149,6 +161,8 @@ namespace Dsp {
                 m_analogProto);
 
             Cascade::setLayout(m_digitalProto);
+
+            DesignCache::store(key, *this);
         }
 
         void BandPassBase::setup(int order,
@@ -157,6 +171,12 @@ namespace Dsp {
             double widthFrequency,
             double stopBandDb)
         {
+            const DesignCache::Key key(DesignCache::familyChebyshevII, kindBandPass, order,
+                centerFrequency / sampleRate, widthFrequency / sampleRate, 0,
+                stopBandDb);
+            if (DesignCache::load(key, *this))
+                return;
+
             m_analogProto.design(order, stopBandDb);
 
             BandPassTransform(centerFrequency / sampleRate,
@@ -165,6 +185,8 @@ namespace Dsp {
                 m_analogProto);
 
             Cascade::setLayout(m_digitalProto);
+
+            DesignCache::store(key, *this);
         }
 
         void BandStopBase::setup(int order,
@@ -173,6 +195,12 @@ namespace Dsp {
             double widthFrequency,
             double stopBandDb)
         {
+            const DesignCache::Key key(DesignCache::familyChebyshevII, kindBandStop, order,
+                centerFrequency / sampleRate, widthFrequency / sampleRate, 0,
+                stopBandDb);
+            if (DesignCache::load(key, *this))
+                return;
+
             m_analogProto.design(order, stopBandDb);
 
             BandStopTransform(centerFrequency / sampleRate,
@@ -181,6 +209,8 @@ namespace Dsp {
                 m_analogProto);
 
             Cascade::setLayout(m_digitalProto);
+
+            DesignCache::store(key, *this);
         }
 
         void LowShelfBase::setup(int order,
@@ -189,6 +219,11 @@ namespace Dsp {
             double gainDb,
             double stopBandDb)
         {
+            const DesignCache::Key key(DesignCache::familyChebyshevII, kindLowShelf, order,
+                cutoffFrequency / sampleRate, 0, gainDb, stopBandDb);
+            if (DesignCache::load(key, *this))
+                return;
+
             m_analogProto.design(order, gainDb, stopBandDb);
 
             LowPassTransform(cutoffFrequency / sampleRate,
@@ -196,6 +231,8 @@ namespace Dsp {
                 m_analogProto);
 
             Cascade::setLayout(m_digitalProto);
+
+            DesignCache::store(key, *this);
         }
 
         void HighShelfBase::setup(int order,
@@ -204,6 +241,11 @@ namespace Dsp {
             double gainDb,
             double stopBandDb)
         {
+            const DesignCache::Key key(DesignCache::familyChebyshevII, kindHighShelf, order,
+                cutoffFrequency / sampleRate, 0, gainDb, stopBandDb);
+            if (DesignCache::load(key, *this))
+                return;
+
             m_analogProto.design(order, gainDb, stopBandDb);
 
             HighPassTransform(cutoffFrequency / sampleRate,
@@ -211,6 +253,8 @@ namespace Dsp {
                 m_analogProto);
 
             Cascade::setLayout(m_digitalProto);
+
+            DesignCache::store(key, *this);
         }
 
         void BandShelfBase::setup(int order,
@@ -220,6 +264,12 @@ namespace Dsp {
             double gainDb,
             double stopBandDb)
         {
+            const DesignCache::Key key(DesignCache::familyChebyshevII, kindBandShelf, order,
+                centerFrequency / sampleRate, widthFrequency / sampleRate, gainDb,
+                stopBandDb);
+            if (DesignCache::load(key, *this))
+                return;
+
             m_analogProto.design(order, gainDb, stopBandDb);
 
             BandPassTransform(centerFrequency / sampleRate,
@@ -230,6 +280,8 @@ namespace Dsp {
             m_digitalProto.setNormal(((centerFrequency / sampleRate) < 0.25) ? doublePi : 0, 1);
 
             Cascade::setLayout(m_digitalProto);
+
+            DesignCache::store(key, *this);
         }
 
     }
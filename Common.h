@@ -11,6 +11,7 @@
 
 //#include <assert.h>
 #include <stdlib.h>
+#include <stdint.h>
 
 #include <cassert>
 #include <cfloat>
@@ -19,6 +20,7 @@
 #include <cstring>
 #include <string>
 #include <limits>
+#include <new>
 #include <vector>
 #include <algorithm>
 
@@ -9,10 +9,16 @@
 
 #include "Biquad.h"
 #include "Cascade.h"
+#include "ChannelExecutor.h"
+#include "DesignCache.h"
+#include "DesignService.h"
 #include "Filter.h"
+#include "FilterBank.h"
+#include "ParallelCascade.h"
 #include "PoleFilter.h"
 #include "SmoothedFilter.h"
 #include "State.h"
+#include "StreamPool.h"
 #include "Utilities.h"
 
 #include "Bessel.h"
@@ -0,0 +1,175 @@
+#include "pch.h"
+#include "Common.h"
+#include "DesignCache.h"
+#include "PoleFilter.h"
+
+#include <list>
+#include <map>
+#include <mutex>
+
+namespace Dsp {
+
+    namespace {
+
+        struct Entry
+        {
+            std::vector<Cascade::Stage> stages;
+            std::vector<PoleZeroPair> pairs;
+            int numPoles;
+            double normalW;
+            double normalGain;
+        };
+
+        // Most recently used first, with an index by key
+        struct Cache
+        {
+            typedef std::list<std::pair<DesignCache::Key, Entry> > List;
+            typedef std::map<DesignCache::Key, List::iterator> Index;
+
+            Cache()
+                : capacity(DesignCache::defaultCapacity)
+                , hits(0)
+                , misses(0)
+            {
+            }
+
+            void trim()
+            {
+                while (int(index.size()) > capacity)
+                {
+                    index.erase(entries.back().first);
+                    entries.pop_back();
+                }
+            }
+
+            std::mutex mutex;
+            List entries;
+            Index index;
+            int capacity;
+            unsigned long long hits;
+            unsigned long long misses;
+        };
+
+        Cache& getCache()
+        {
+            static Cache cache;
+            return cache;
+        }
+
+        thread_local int suspended = 0;
+
+    }
+
+    bool DesignCache::Key::operator< (const Key& other) const
+    {
+        if (family != other.family) return family < other.family;
+        if (kind != other.kind) return kind < other.kind;
+        if (order != other.order) return order < other.order;
+        if (frequency != other.frequency) return frequency < other.frequency;
+        if (width != other.width) return width < other.width;
+        if (gainDb != other.gainDb) return gainDb < other.gainDb;
+        if (rippleDb != other.rippleDb) return rippleDb < other.rippleDb;
+        return rolloff < other.rolloff;
+    }
+
+    DesignCache::Suspend::Suspend()
+    {
+        ++suspended;
+    }
+
+    DesignCache::Suspend::~Suspend()
+    {
+        --suspended;
+    }
+
+    void DesignCache::setCapacity(int capacity)
+    {
+        assert(capacity >= 0);
+
+        Cache& cache = getCache();
+        std::lock_guard<std::mutex> lock(cache.mutex);
+        cache.capacity = capacity;
+        cache.trim();
+    }
+
+    void DesignCache::clear()
+    {
+        Cache& cache = getCache();
+        std::lock_guard<std::mutex> lock(cache.mutex);
+        cache.index.clear();
+        cache.entries.clear();
+        cache.hits = 0;
+        cache.misses = 0;
+    }
+
+    DesignCache::Statistics DesignCache::getStatistics()
+    {
+        Cache& cache = getCache();
+        std::lock_guard<std::mutex> lock(cache.mutex);
+        Statistics statistics;
+        statistics.hits = cache.hits;
+        statistics.misses = cache.misses;
+        statistics.size = int(cache.index.size());
+        statistics.capacity = cache.capacity;
+        return statistics;
+    }
+
+    bool DesignCache::load(const Key& key, PoleFilterBase2& filter)
+    {
+        if (suspended)
+            return false;
+
+        Cache& cache = getCache();
+        std::lock_guard<std::mutex> lock(cache.mutex);
+        if (cache.capacity == 0)
+            return false;
+
+        Cache::Index::iterator found = cache.index.find(key);
+        if (found == cache.index.end())
+        {
+            ++cache.misses;
+            return false;
+        }
+
+        ++cache.hits;
+        cache.entries.splice(cache.entries.begin(), cache.entries, found->second);
+
+        const Entry& entry = found->second->second;
+        filter.setStages(int(entry.stages.size()), &entry.stages[0]);
+        filter.m_digitalProto.assign(entry.numPoles, &entry.pairs[0],
+            entry.normalW, entry.normalGain);
+        return true;
+    }
+
+    void DesignCache::store(const Key& key, const PoleFilterBase2& filter)
+    {
+        if (suspended)
+            return;
+
+        const LayoutBase& layout = filter.m_digitalProto;
+        const int numStages = filter.getNumStages();
+        if (numStages == 0)
+            return;
+
+        // Copy outside the lock
+        Entry entry;
+        entry.stages.reserve(numStages);
+        for (int i = 0; i < numStages; ++i)
+            entry.stages.push_back(filter[i]);
+        for (int i = 0; i < (layout.getNumPoles() + 1) / 2; ++i)
+            entry.pairs.push_back(layout[i]);
+        entry.numPoles = layout.getNumPoles();
+        entry.normalW = layout.getNormalW();
+        entry.normalGain = layout.getNormalGain();
+
+        Cache& cache = getCache();
+        std::lock_guard<std::mutex> lock(cache.mutex);
+        if (cache.capacity == 0 || cache.index.count(key))
+            return;
+
+        cache.entries.push_front(std::make_pair(key, entry));
+        cache.index[key] = cache.entries.begin();
+        cache.trim();
+    }
+
+}
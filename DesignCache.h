@@ -0,0 +1,116 @@
+#ifndef DSPFILTERS_DESIGNCACHE_H
+#define DSPFILTERS_DESIGNCACHE_H
+
+#include "Common.h"
+#include "Types.h"
+
+namespace Dsp {
+
+    class PoleFilterBase2;
+
+    /*
+     * Remembers the most recently used pole filter designs.
+     *
+     * Calling setup() on a Butterworth, ChebyshevI, ChebyshevII, Elliptic,
+     * Bessel or Legendre filter first looks for a design with the same
+     * family, kind, order, normalized frequencies, gain, ripple and
+     * rolloff. If there is one, its stages and its digital poles and zeros
+     * are copied into the filter instead of designing it again, with the
+     * same result. Recalling presets and automating between a few settings
+     * then costs a copy.
+     *
+     * There is one cache for the whole process, safe to use from any
+     * thread. When it is full the least recently used design is dropped.
+     *
+     */
+    class DesignCache
+    {
+    public:
+        enum Family
+        {
+            familyButterworth,
+            familyChebyshevI,
+            familyChebyshevII,
+            familyElliptic,
+            familyBessel,
+            familyLegendre
+        };
+
+        // Everything a pole filter design depends on. Frequencies are
+        // normalized to the sample rate; rippleDb is the stop band
+        // attenuation for ChebyshevII.
+        struct Key
+        {
+            Key(Family family_,
+                Kind kind_,
+                int order_,
+                double frequency_,
+                double width_ = 0,
+                double gainDb_ = 0,
+                double rippleDb_ = 0,
+                double rolloff_ = 0)
+                : family(family_)
+                , kind(kind_)
+                , order(order_)
+                , frequency(frequency_)
+                , width(width_)
+                , gainDb(gainDb_)
+                , rippleDb(rippleDb_)
+                , rolloff(rolloff_)
+            {
+            }
+
+            bool operator< (const Key& other) const;
+
+            Family family;
+            Kind kind;
+            int order;
+            double frequency;
+            double width;
+            double gainDb;
+            double rippleDb;
+            double rolloff;
+        };
+
+        // While one of these exists, setup() on the constructing thread
+        // neither looks in the cache nor adds to it. For designs that are
+        // never repeated, such as the steps of a smoothed transition.
+        class Suspend
+        {
+        public:
+            Suspend();
+            ~Suspend();
+        };
+
+        struct Statistics
+        {
+            unsigned long long hits;
+            unsigned long long misses;
+            int size;
+            int capacity;
+        };
+
+        // The number of designs kept, 0 turns the cache off
+        static void setCapacity(int capacity);
+
+        // Drop every design and zero the counters
+        static void clear();
+
+        static Statistics getStatistics();
+
+        /*@Internal*/
+        // Copy the design with this key into filter, false if there is none
+        static bool load(const Key& key, PoleFilterBase2& filter);
+
+        /*@Internal*/
+        static void store(const Key& key, const PoleFilterBase2& filter);
+
+        enum
+        {
+            defaultCapacity = 256
+        };
+    };
+
+}
+
+#endif
@@ -0,0 +1,119 @@
+#include "pch.h"
+#include "Common.h"
+#include "DesignService.h"
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+namespace Dsp {
+
+    DesignService::Client::Client()
+        : m_queued(false)
+    {
+        m_pending.clear();
+    }
+
+    DesignService::Client::~Client()
+    {
+    }
+
+    //------------------------------------------------------------------------------
+
+    struct DesignService::Impl
+    {
+        Impl()
+            : running(0)
+            , stop(false)
+        {
+        }
+
+        void workerLoop()
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            for (;;)
+            {
+                while (queue.empty() && !stop)
+                    wake.wait(lock);
+                if (stop)
+                    return;
+
+                Client* client = queue.front();
+                queue.pop_front();
+                client->m_queued = false;
+                const Params parameters = client->m_pending;
+                running = client;
+
+                lock.unlock();
+                client->redesign(parameters);
+                lock.lock();
+
+                running = 0;
+                idle.notify_all();
+            }
+        }
+
+        std::mutex mutex;
+        std::condition_variable wake;
+        std::condition_variable idle;
+        std::deque<Client*> queue;
+        Client* running;
+        bool stop;
+        std::thread worker;
+    };
+
+    //------------------------------------------------------------------------------
+
+    DesignService::DesignService()
+        : m_impl(new Impl)
+    {
+        m_impl->worker = std::thread(&Impl::workerLoop, m_impl);
+    }
+
+    DesignService::~DesignService()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_impl->mutex);
+            m_impl->stop = true;
+        }
+        m_impl->wake.notify_one();
+        m_impl->worker.join();
+
+        delete m_impl;
+    }
+
+    void DesignService::post(Client* client, const Params& parameters)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_impl->mutex);
+            client->m_pending = parameters;
+            if (client->m_queued)
+                return;
+            client->m_queued = true;
+            m_impl->queue.push_back(client);
+        }
+        m_impl->wake.notify_one();
+    }
+
+    void DesignService::cancel(Client* client)
+    {
+        std::unique_lock<std::mutex> lock(m_impl->mutex);
+        if (client->m_queued)
+        {
+            m_impl->queue.erase(std::find(m_impl->queue.begin(),
+                m_impl->queue.end(), client));
+            client->m_queued = false;
+        }
+        while (m_impl->running == client)
+            m_impl->idle.wait(lock);
+    }
+
+    void DesignService::flush()
+    {
+        std::unique_lock<std::mutex> lock(m_impl->mutex);
+        while (!m_impl->queue.empty() || m_impl->running)
+            m_impl->idle.wait(lock);
+    }
+
+}
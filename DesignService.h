@@ -0,0 +1,308 @@
+#ifndef DSPFILTERS_DESIGNSERVICE_H
+#define DSPFILTERS_DESIGNSERVICE_H
+
+#include "Common.h"
+#include "Filter.h"
+#include "Params.h"
+
+#include <atomic>
+
+namespace Dsp {
+
+    /*
+     * Designs filters on a worker thread.
+     *
+     * Designing can take a long time, Elliptic and Legendre designs find
+     * polynomial roots, so a filter owned by the audio thread should not be
+     * redesigned there, nor by another thread while it is processing. A
+     * DesignService runs the designs of any number of AsyncFilterDesign
+     * filters on one worker thread of its own. Requests for a filter that
+     * arrive while an earlier one is still waiting are merged, so only the
+     * latest parameters are designed.
+     *
+     * The service must outlive every filter that uses it, since a filter
+     * cancels its requests with it as it goes away.
+     *
+     */
+    class DesignService
+    {
+    public:
+        // A filter that is designed by the service
+        class Client
+        {
+        public:
+            Client();
+
+        protected:
+            virtual ~Client();
+
+        private:
+            friend class DesignService;
+
+            // Called on the worker thread with the latest parameters
+            virtual void redesign(const Params& parameters) = 0;
+
+            Params m_pending;
+            bool m_queued;
+        };
+
+        DesignService();
+        ~DesignService();
+
+        // Ask for client to be designed with parameters. A request that is
+        // still waiting is replaced.
+        void post(Client* client, const Params& parameters);
+
+        // Drop the waiting request of client and wait for a design of it
+        // that is already running. Clients call this before they go away.
+        void cancel(Client* client);
+
+        // Wait until every request made so far has been designed
+        void flush();
+
+    private:
+        DesignService(const DesignService&);
+        DesignService& operator= (const DesignService&);
+
+        struct Impl;
+        Impl* m_impl;
+    };
+
+    //------------------------------------------------------------------------------
+
+    /*
+     * A FilterDesign whose setParams() returns at once and designs on a
+     * DesignService instead.
+     *
+     * The finished coefficients go into one of three copies of the design.
+     * The worker publishes a copy by swapping its index with an atomic
+     * exchange, and process() picks up the newest one at the start of a
+     * block, without taking a lock. Until the first design is done the
+     * filter passes its input through; call flush() on the service to wait
+     * for it.
+     *
+     * response(), the response grids and getPoleZeros() design a copy of
+     * their own on the calling thread when they are first asked after a
+     * parameter change.
+     *
+     */
+    template <class DesignClass,
+        int Channels = 0,
+        class StateType = DirectFormII,
+        class Denormal = DenormalPrevention>
+        class AsyncFilterDesign
+        : public FilterDesignBase <DesignClass>
+        , private DesignService::Client
+    {
+    public:
+        // service must outlive the filter
+        explicit AsyncFilterDesign(DesignService& service)
+            : m_service(service)
+            , m_front(0)
+            , m_back(1)
+            , m_ready(2)
+            , m_published(false)
+            , m_designCurrent(false)
+        {
+            for (int i = 0; i < 3; ++i)
+                compileStagesFor<typename state_t::state_type_t::value_type>(
+                    &m_copies[i]);
+        }
+
+        ~AsyncFilterDesign()
+        {
+            m_service.cancel(this);
+        }
+
+        std::vector<PoleZeroPair> getPoleZeros() const
+        {
+            return getDesign().getPoleZeros();
+        }
+
+        int getPoleZeros(PoleZeroPair* pairs, int maxPairs) const
+        {
+            return getDesign().getPoleZeros(pairs, maxPairs);
+        }
+
+        complex_t response(double normalizedFrequency) const
+        {
+            return getDesign().response(normalizedFrequency);
+        }
+
+        void responseGrid(const double* normalizedFrequencies,
+            int numFrequencies,
+            complex_t* response) const
+        {
+            getDesign().responseGrid(normalizedFrequencies, numFrequencies,
+                response);
+        }
+
+        void responseGrid(double first,
+            double last,
+            int numFrequencies,
+            Spacing spacing,
+            complex_t* response) const
+        {
+            getDesign().responseGrid(first, last, numFrequencies, spacing,
+                response);
+        }
+
+        void magnitudeDbGrid(const double* normalizedFrequencies,
+            int numFrequencies,
+            double* magnitudeDb) const
+        {
+            getDesign().magnitudeDbGrid(normalizedFrequencies, numFrequencies,
+                magnitudeDb);
+        }
+
+        void magnitudeDbGrid(double first,
+            double last,
+            int numFrequencies,
+            Spacing spacing,
+            double* magnitudeDb) const
+        {
+            getDesign().magnitudeDbGrid(first, last, numFrequencies, spacing,
+                magnitudeDb);
+        }
+
+        int getNumChannels()
+        {
+            return m_state.getNumChannels();
+        }
+
+        // Only for Channels = dynamicChannels, resets every channel
+        void setNumChannels(int numChannels)
+        {
+            m_state.setNumChannels(numChannels);
+        }
+
+        // Process the channels in parallel, see ChannelExecutor
+        void setExecutor(ChannelExecutor* executor)
+        {
+            m_state.setExecutor(executor);
+        }
+
+        void reset()
+        {
+            m_state.reset();
+        }
+
+        void process(int numSamples, float* const* arrayOfChannels)
+        {
+            if (DesignClass* design = acquire())
+                m_state.process(numSamples, arrayOfChannels, *design);
+        }
+
+        void process(int numSamples, double* const* arrayOfChannels)
+        {
+            if (DesignClass* design = acquire())
+                m_state.process(numSamples, arrayOfChannels, *design);
+        }
+
+        void process(int numSamples, float* frames, int frameStride)
+        {
+            if (DesignClass* design = acquire())
+                m_state.process(numSamples, frames, frameStride, *design);
+        }
+
+        void process(int numSamples, double* frames, int frameStride)
+        {
+            if (DesignClass* design = acquire())
+                m_state.process(numSamples, frames, frameStride, *design);
+        }
+
+        void process(int numSamples,
+            const float* const* sourceChannels,
+            float* const* arrayOfChannels)
+        {
+            if (DesignClass* design = acquire())
+                m_state.process(numSamples, sourceChannels, arrayOfChannels,
+                    *design);
+            else
+                passThrough(numSamples, sourceChannels, arrayOfChannels);
+        }
+
+        void process(int numSamples,
+            const double* const* sourceChannels,
+            double* const* arrayOfChannels)
+        {
+            if (DesignClass* design = acquire())
+                m_state.process(numSamples, sourceChannels, arrayOfChannels,
+                    *design);
+            else
+                passThrough(numSamples, sourceChannels, arrayOfChannels);
+        }
+
+    protected:
+        void doSetParams(const Params& parameters)
+        {
+            m_designCurrent = false;
+            m_service.post(this, parameters);
+        }
+
+    private:
+        enum
+        {
+            fresh = 4 // set in m_ready until process() takes the copy
+        };
+
+        // On the worker thread
+        void redesign(const Params& parameters)
+        {
+            m_copies[m_back].setParams(parameters);
+            m_back = m_ready.exchange(m_back | fresh, std::memory_order_acq_rel) & ~fresh;
+        }
+
+        // On the processing thread, switches to the newest copy. Returns 0
+        // until the first one is published.
+        DesignClass* acquire()
+        {
+            if (m_ready.load(std::memory_order_relaxed) & fresh)
+            {
+                m_front = m_ready.exchange(m_front, std::memory_order_acq_rel) & ~fresh;
+                m_published = true;
+            }
+            return m_published ? &m_copies[m_front] : 0;
+        }
+
+        template <typename Sample>
+        void passThrough(int numSamples,
+            const Sample* const* sourceChannels,
+            Sample* const* arrayOfChannels)
+        {
+            for (int i = m_state.getNumChannels(); --i >= 0;)
+                if (arrayOfChannels[i] != sourceChannels[i])
+                    std::copy(sourceChannels[i], sourceChannels[i] + numSamples,
+                        arrayOfChannels[i]);
+        }
+
+        const DesignClass& getDesign() const
+        {
+            if (!m_designCurrent)
+            {
+                DesignClass& design = const_cast<DesignClass&>(this->m_design);
+                design.setParams(this->getParams());
+                m_designCurrent = true;
+            }
+            return this->m_design;
+        }
+
+    private:
+        DesignService& m_service;
+
+        DesignClass m_copies[3];
+        int m_front;                // owned by the processing thread
+        int m_back;                 // owned by the worker
+        std::atomic<int> m_ready;   // the third, with fresh if unseen
+        bool m_published;           // false until the first design is done
+
+        mutable bool m_designCurrent;
+
+        typedef typename DesignClass::template State <StateType, Denormal> state_t;
+
+        ChannelsState <Channels, state_t> m_state;
+    };
+
+}
+
+#endif
@@ -0,0 +1,161 @@
+#include "pch.h"
+#include "Common.h"
+#include "Biquad.h"
+#include "Dispatch.h"
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#  include <intrin.h>
+#  define DSPFILTERS_CPUID_MSVC 1
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#  include <cpuid.h>
+#  define DSPFILTERS_CPUID_GCC 1
+#endif
+
+namespace Dsp {
+
+    namespace Dispatch {
+
+        namespace {
+
+#if defined(DSPFILTERS_CPUID_MSVC)
+            void cpuid(int leaf, unsigned int regs[4])
+            {
+                int r[4];
+                __cpuidex(r, leaf, 0);
+                for (int i = 0; i < 4; ++i)
+                    regs[i] = static_cast<unsigned int>(r[i]);
+            }
+
+            unsigned long long xgetbv()
+            {
+                return _xgetbv(0);
+            }
+#elif defined(DSPFILTERS_CPUID_GCC)
+            void cpuid(int leaf, unsigned int regs[4])
+            {
+                __cpuid_count(leaf, 0, regs[0], regs[1], regs[2], regs[3]);
+            }
+
+            unsigned long long xgetbv()
+            {
+                unsigned int lo;
+                unsigned int hi;
+                __asm__ __volatile__("xgetbv" : "=a"(lo), "=d"(hi) : "c"(0));
+                return (static_cast<unsigned long long>(hi) << 32) | lo;
+            }
+#endif
+
+            const KernelTable* selectKernelTable()
+            {
+                switch (detectTarget())
+                {
+                case targetAvx512:
+                    if (getAvx512Kernels())
+                        return getAvx512Kernels();
+                    // fall through
+                case targetAvx:
+                    if (getAvxKernels())
+                        return getAvxKernels();
+                    // fall through
+                case targetSse2:
+                    return getSse2Kernels();
+                default:
+                    return 0;
+                };
+            }
+
+        }
+
+        Target detectTarget()
+        {
+#if defined(DSPFILTERS_CPUID_MSVC) || defined(DSPFILTERS_CPUID_GCC)
+            unsigned int regs[4];
+
+            cpuid(0, regs);
+            const unsigned int maxLeaf = regs[0];
+            if (maxLeaf < 1)
+                return targetNone;
+
+            cpuid(1, regs);
+            const bool sse2 = (regs[3] & (1u << 26)) != 0;
+            const bool osxsave = (regs[2] & (1u << 27)) != 0;
+            const bool avx = (regs[2] & (1u << 28)) != 0;
+
+            if (!sse2)
+                return targetNone;
+
+            // The operating system has to save the wider registers on a
+            // context switch: XMM and YMM state for AVX, and the mask and
+            // upper ZMM state for AVX-512.
+            if (!osxsave || !avx)
+                return targetSse2;
+
+            const unsigned long long xcr0 = xgetbv();
+            if ((xcr0 & 0x6) != 0x6)
+                return targetSse2;
+
+            if (maxLeaf >= 7)
+            {
+                cpuid(7, regs);
+                const bool avx512f = (regs[1] & (1u << 16)) != 0;
+                if (avx512f && (xcr0 & 0xe0) == 0xe0)
+                    return targetAvx512;
+            }
+
+            return targetAvx;
+#else
+            return targetNone;
+#endif
+        }
+
+        const KernelTable* getKernelTable()
+        {
+            static const KernelTable* const table = selectKernelTable();
+            return table;
+        }
+
+        void response(int count,
+            const double* cosines,
+            const double* sines,
+            int numStages,
+            const BiquadCoefficients<double>* stageArray,
+            double* real,
+            double* imag,
+            double* power)
+        {
+            const KernelTable* table = getKernelTable();
+            const int done = table
+                ? table->response(count, cosines, sines, numStages,
+                    stageArray, real, imag, power)
+                : responseLanes<Simd::Native>(count, cosines, sines,
+                    numStages, stageArray, real, imag, power);
+
+            // the leftovers run on the baseline instruction set
+            responseLanes<Simd::Scalar>(count - done, cosines + done,
+                sines + done, numStages, stageArray, real + done,
+                imag + done, power + done);
+        }
+
+        void magnitude(int count,
+            const double* cosines,
+            const double* sines,
+            int numStages,
+            const BiquadCoefficients<double>* stageArray,
+            double* numerator,
+            double* denominator)
+        {
+            const KernelTable* table = getKernelTable();
+            const int done = table
+                ? table->magnitude(count, cosines, sines, numStages,
+                    stageArray, numerator, denominator)
+                : magnitudeLanes<Simd::Native>(count, cosines, sines,
+                    numStages, stageArray, numerator, denominator);
+
+            magnitudeLanes<Simd::Scalar>(count - done, cosines + done,
+                sines + done, numStages, stageArray, numerator + done,
+                denominator + done);
+        }
+
+    }
+
+}
@@ -0,0 +1,617 @@
+#ifndef DSPFILTERS_DISPATCH_H
+#define DSPFILTERS_DISPATCH_H
+
+#include "Common.h"
+#include "MathSupplement.h"
+#include "Simd.h"
+
+namespace Dsp {
+
+    class SkewedDirectFormII;
+
+    template <typename Value>
+    struct BiquadCoefficients;
+
+    /*
+     * Runtime selection of the vector kernels
+     *
+     * The lane-parallel kernels are compiled into the library once for each
+     * instruction set, each in its own translation unit (DispatchSse2.cpp,
+     * DispatchAvx.cpp and DispatchAvx512.cpp), and the widest set that the
+     * processor and operating system support is picked the first time a
+     * kernel is needed. A single build then runs the AVX-512 kernels where
+     * they are available and falls back to AVX or SSE2 elsewhere.
+     *
+     * Only common combinations are compiled in: float and double samples,
+     * the vectorized state forms, and sections of a Cascade or a lone
+     * Biquad. Anything else uses the kernels of the including translation
+     * unit, built for whatever instruction set the caller was compiled for.
+     *
+     */
+
+    namespace Dispatch {
+
+        enum Target
+        {
+            targetNone,
+            targetSse2,
+            targetAvx,
+            targetAvx512
+        };
+
+        // The widest instruction set supported by the processor
+        Target detectTarget();
+
+        // Generic function pointer, cast back to its real type on use
+        typedef void(*Function)();
+
+        enum
+        {
+            numSampleTypes = 2,
+            numForms = 6,
+            numStageTypes = 2
+        };
+
+        // Kernels compiled for one instruction set
+        struct KernelTable
+        {
+            Target target;
+
+            // processChannels for [sample][form][stage], see the Index traits
+            Function channels[numSampleTypes][numForms][numStageTypes];
+
+            // SkewedPipeline::process for [sample][stage]
+            Function skewed[numSampleTypes][numStageTypes];
+
+            void(*addFloat)(int samples, float* dest, const float* src);
+            void(*addDouble)(int samples, double* dest, const double* src);
+            void(*multiplyFloat)(int samples, float* dest, float factor);
+            void(*multiplyDouble)(int samples, double* dest, double factor);
+
+            // responseLanes and magnitudeLanes on whole vectors, returning
+            // how many points they took
+            int(*response)(int count,
+                const double* cosines,
+                const double* sines,
+                int numStages,
+                const BiquadCoefficients<double>* stageArray,
+                double* real,
+                double* imag,
+                double* power);
+            int(*magnitude)(int count,
+                const double* cosines,
+                const double* sines,
+                int numStages,
+                const BiquadCoefficients<double>* stageArray,
+                double* numerator,
+                double* denominator);
+        };
+
+        // The table for the running processor, or 0 if none was compiled in.
+        const KernelTable* getKernelTable();
+
+        /*@Internal*/
+        // Tables of the kernel translation units, 0 where the compiler could
+        // not target the instruction set or, for the wider ones, did not
+        // optimize (see DispatchKernels.h).
+        const KernelTable* getSse2Kernels();
+        const KernelTable* getAvxKernels();
+        const KernelTable* getAvx512Kernels();
+
+        //------------------------------------------------------------------------------
+
+        // Position of a type in the kernel table, or -1 if not compiled in.
+        // The forms and stages specialize these next to their definitions.
+
+        template <typename Sample>
+        struct SampleIndex
+        {
+            enum { value = -1 };
+        };
+
+        template <>
+        struct SampleIndex <float>
+        {
+            enum { value = 0 };
+        };
+
+        template <>
+        struct SampleIndex <double>
+        {
+            enum { value = 1 };
+        };
+
+        template <class StateType>
+        struct FormIndex
+        {
+            enum { value = -1 };
+        };
+
+        template <class Stage>
+        struct StageIndex
+        {
+            enum { value = -1 };
+        };
+
+        template <typename Source, typename Sample>
+        struct IsSame
+        {
+            enum { value = false };
+        };
+
+        template <typename Sample>
+        struct IsSame <Sample, Sample>
+        {
+            enum { value = true };
+        };
+
+        // The kernels read and write the same sample type
+        template <typename Source, typename Sample, class StateType, class Stage>
+        struct IsCompiled
+        {
+            enum
+            {
+                value = IsSame<Source, Sample>::value &&
+                SampleIndex<Sample>::value >= 0 &&
+                FormIndex<StateType>::value >= 0 &&
+                StageIndex<Stage>::value >= 0
+            };
+        };
+
+        template <bool>
+        struct Bool
+        {
+        };
+
+        //------------------------------------------------------------------------------
+
+        // The state of one channel as seen by the compiled kernels
+        template <class StateType>
+        struct ChannelRef
+        {
+            typedef StateType state_type_t;
+
+            StateType* getStateArray()
+            {
+                return states;
+            }
+
+            DenormalPrevention& getDenormalPrevention()
+            {
+                return *denormal;
+            }
+
+            StateType* states;
+            DenormalPrevention* denormal;
+        };
+
+        // Processes whole vectors of channels and returns how many
+        // channels it took, leaving the rest to the caller.
+        template <typename Sample, class StateType, class Stage>
+        struct ChannelKernel
+        {
+            typedef int(*Type)(int numSamples,
+                int numChannels,
+                const Sample* const* sourceChannels,
+                Sample* const* arrayOfChannels,
+                ChannelRef<StateType>* stateArray,
+                int numStages,
+                const Stage* stageArray,
+                int stride);
+        };
+
+        template <typename Sample, class Stage>
+        struct SkewedKernel
+        {
+            typedef bool(*Type)(int numSamples,
+                Sample* dest,
+                int numStages,
+                const Stage* stageArray,
+                SkewedDirectFormII* stateArray,
+                DenormalPrevention& denormal);
+        };
+
+        template <class ChannelState, class Stage, typename Source, typename Sample>
+        void processChannels(int numSamples,
+            int numChannels,
+            const Source* const* sourceChannels,
+            Sample* const* arrayOfChannels,
+            ChannelState* stateArray,
+            int numStages,
+            const Stage* stageArray,
+            int stride,
+            Bool<false>)
+        {
+            typedef typename ChannelState::state_type_t StateType;
+            LaneGroups<typename LaneVectors<StateType>::native_t>::process(
+                numSamples, numChannels, sourceChannels, arrayOfChannels,
+                stateArray, numStages, stageArray, stride);
+        }
+
+        template <class ChannelState, class Stage, typename Sample>
+        void processChannels(int numSamples,
+            int numChannels,
+            const Sample* const* sourceChannels,
+            Sample* const* arrayOfChannels,
+            ChannelState* stateArray,
+            int numStages,
+            const Stage* stageArray,
+            int stride,
+            Bool<true>)
+        {
+            typedef typename ChannelState::state_type_t StateType;
+            typedef typename ChannelKernel<Sample, StateType, Stage>::Type Kernel;
+
+            const KernelTable* table = getKernelTable();
+            if (!table)
+            {
+                processChannels(numSamples, numChannels, sourceChannels,
+                    arrayOfChannels, stateArray, numStages, stageArray, stride,
+                    Bool<false>());
+                return;
+            }
+
+            const Kernel kernel = reinterpret_cast<Kernel>(table->channels
+                [SampleIndex<Sample>::value]
+                [FormIndex<StateType>::value]
+                [StageIndex<Stage>::value]);
+
+            // a multiple of every lane count
+            const int batchChannels = 16;
+            ChannelRef<StateType> refs[batchChannels];
+
+            while (numChannels > 0)
+            {
+                const int count = std::min(numChannels, batchChannels);
+                for (int i = 0; i < count; ++i)
+                {
+                    refs[i].states = stateArray[i].getStateArray();
+                    refs[i].denormal = &stateArray[i].getDenormalPrevention();
+                }
+
+                const int done = kernel(numSamples, count, sourceChannels,
+                    arrayOfChannels, refs, numStages, stageArray, stride);
+
+                // the narrower leftovers run on the caller's vectors
+                if (done < count)
+                    processChannels(numSamples, count - done,
+                        sourceChannels + done, arrayOfChannels + done,
+                        stateArray + done, numStages, stageArray, stride,
+                        Bool<false>());
+
+                sourceChannels += count;
+                arrayOfChannels += count;
+                stateArray += count;
+                numChannels -= count;
+            }
+        }
+
+        //------------------------------------------------------------------------------
+
+        // Buffer routines for contiguous samples, see Utilities.h
+
+        template <typename Td, typename Ts>
+        void add(int samples, Td* dest, Ts const* src)
+        {
+            while (--samples >= 0)
+                *dest++ += static_cast<Td>(*src++);
+        }
+
+        inline void add(int samples, float* dest, const float* src)
+        {
+            const KernelTable* table = getKernelTable();
+            if (table)
+                table->addFloat(samples, dest, src);
+            else
+                add<float, float>(samples, dest, src);
+        }
+
+        inline void add(int samples, double* dest, const double* src)
+        {
+            const KernelTable* table = getKernelTable();
+            if (table)
+                table->addDouble(samples, dest, src);
+            else
+                add<double, double>(samples, dest, src);
+        }
+
+        template <typename Td, typename Ty>
+        void multiply(int samples, Td* dest, Ty factor)
+        {
+            while (--samples >= 0) {
+                *dest = static_cast<Td>(*dest * factor);
+                dest++;
+            }
+        }
+
+        inline void multiply(int samples, float* dest, float factor)
+        {
+            const KernelTable* table = getKernelTable();
+            if (table)
+                table->multiplyFloat(samples, dest, factor);
+            else
+                multiply<float, float>(samples, dest, factor);
+        }
+
+        inline void multiply(int samples, double* dest, double factor)
+        {
+            const KernelTable* table = getKernelTable();
+            if (table)
+                table->multiplyDouble(samples, dest, factor);
+            else
+                multiply<double, double>(samples, dest, factor);
+        }
+
+        //------------------------------------------------------------------------------
+
+        // Frequency response of a cascade of normalized sections, one point
+        // in each lane. The point is z = cosine + i sine on the unit circle
+        // and the response comes out as (real + i imag) / power, leaving the
+        // one division to the caller. Takes whole vectors of points and
+        // returns how many it did.
+        template <class Vec, class Stage>
+        int responseLanes(int count,
+            const double* cosines,
+            const double* sines,
+            int numStages,
+            const Stage* stageArray,
+            double* real,
+            double* imag,
+            double* power)
+        {
+            const Vec zero = Vec::broadcast(0);
+            const Vec one = Vec::broadcast(1);
+
+            int done = 0;
+            for (; count - done >= Vec::lanes; done += Vec::lanes)
+            {
+                // z^-1 and z^-2, conjugated
+                const Vec c1 = Vec::load(cosines + done);
+                const Vec s1 = Vec::load(sines + done);
+                const Vec c2 = c1 * c1 - s1 * s1;
+                const Vec s2 = (c1 + c1) * s1;
+
+                Vec nr = one;
+                Vec ni = zero;
+                Vec dr = one;
+                Vec di = zero;
+                const Stage* stage = stageArray;
+                for (int i = numStages; --i >= 0; ++stage)
+                {
+                    const Vec b1 = Vec::broadcast(stage->b1);
+                    const Vec b2 = Vec::broadcast(stage->b2);
+                    const Vec a1 = Vec::broadcast(stage->a1);
+                    const Vec a2 = Vec::broadcast(stage->a2);
+                    const Vec tr = Vec::broadcast(stage->b0) + b1 * c1 + b2 * c2;
+                    const Vec ti = zero - (b1 * s1 + b2 * s2);
+                    const Vec br = one + a1 * c1 + a2 * c2;
+                    const Vec bi = zero - (a1 * s1 + a2 * s2);
+
+                    const Vec n = nr * tr - ni * ti;
+                    ni = nr * ti + ni * tr;
+                    nr = n;
+                    const Vec d = dr * br - di * bi;
+                    di = dr * bi + di * br;
+                    dr = d;
+                }
+
+                // N / D = N conj(D) / |D|^2
+                (nr * dr + ni * di).store(real + done);
+                (ni * dr - nr * di).store(imag + done);
+                (dr * dr + di * di).store(power + done);
+            }
+
+            return done;
+        }
+
+        // Squared magnitudes of the numerator and denominator of the same
+        template <class Vec, class Stage>
+        int magnitudeLanes(int count,
+            const double* cosines,
+            const double* sines,
+            int numStages,
+            const Stage* stageArray,
+            double* numerator,
+            double* denominator)
+        {
+            const Vec one = Vec::broadcast(1);
+
+            int done = 0;
+            for (; count - done >= Vec::lanes; done += Vec::lanes)
+            {
+                const Vec c1 = Vec::load(cosines + done);
+                const Vec s1 = Vec::load(sines + done);
+                const Vec c2 = c1 * c1 - s1 * s1;
+                const Vec s2 = (c1 + c1) * s1;
+
+                Vec n = one;
+                Vec d = one;
+                const Stage* stage = stageArray;
+                for (int i = numStages; --i >= 0; ++stage)
+                {
+                    const Vec b1 = Vec::broadcast(stage->b1);
+                    const Vec b2 = Vec::broadcast(stage->b2);
+                    const Vec a1 = Vec::broadcast(stage->a1);
+                    const Vec a2 = Vec::broadcast(stage->a2);
+                    const Vec tr = Vec::broadcast(stage->b0) + b1 * c1 + b2 * c2;
+                    const Vec ti = b1 * s1 + b2 * s2;
+                    const Vec br = one + a1 * c1 + a2 * c2;
+                    const Vec bi = a1 * s1 + a2 * s2;
+
+                    n = n * (tr * tr + ti * ti);
+                    d = d * (br * br + bi * bi);
+                }
+
+                n.store(numerator + done);
+                d.store(denominator + done);
+            }
+
+            return done;
+        }
+
+        // responseLanes and magnitudeLanes for any count, with the best
+        // kernels for the processor
+        void response(int count,
+            const double* cosines,
+            const double* sines,
+            int numStages,
+            const BiquadCoefficients<double>* stageArray,
+            double* real,
+            double* imag,
+            double* power);
+
+        void magnitude(int count,
+            const double* cosines,
+            const double* sines,
+            int numStages,
+            const BiquadCoefficients<double>* stageArray,
+            double* numerator,
+            double* denominator);
+
+    }
+
+    // Process a block of samples for several channels through a cascade of
+    // sections in SIMD lanes, with the best kernels for the processor.
+    // Samples of a channel are stride apart.
+    template <class ChannelState, class Stage, typename Sample>
+    void processChannels(int numSamples,
+        int numChannels,
+        Sample* const* arrayOfChannels,
+        ChannelState* stateArray,
+        int numStages,
+        const Stage* stageArray,
+        int stride = 1)
+    {
+        typedef typename ChannelState::state_type_t StateType;
+        Dispatch::processChannels(numSamples, numChannels, arrayOfChannels,
+            arrayOfChannels, stateArray, numStages, stageArray, stride,
+            Dispatch::Bool<Dispatch::IsCompiled<Sample, Sample, StateType, Stage>::value>());
+    }
+
+    // Process channels out of place, reading from sourceChannels and
+    // writing to arrayOfChannels. The source is converted to Sample as it
+    // is read; the output is identical to copying it over first.
+    template <class ChannelState, class Stage, typename Source, typename Sample>
+    void processChannels(int numSamples,
+        int numChannels,
+        const Source* const* sourceChannels,
+        Sample* const* arrayOfChannels,
+        ChannelState* stateArray,
+        int numStages,
+        const Stage* stageArray,
+        int stride = 1)
+    {
+        typedef typename ChannelState::state_type_t StateType;
+        Dispatch::processChannels(numSamples, numChannels, sourceChannels,
+            arrayOfChannels, stateArray, numStages, stageArray, stride,
+            Dispatch::Bool<Dispatch::IsCompiled<Source, Sample, StateType, Stage>::value>());
+    }
+
+    // Process a block of samples for several channels through sections
+    // that change every sample: the numStages stages of each sample follow
+    // those of the one before in trajectory. Groups of channels run in SIMD
+    // lanes, and the output is identical to processing each channel with a
+    // cascade holding the stages of each sample in turn.
+    template <class ChannelState, class Stage, typename Source, typename Sample>
+    void processChannelTrajectory(int numSamples,
+        int numChannels,
+        const Source* const* sourceChannels,
+        Sample* const* arrayOfChannels,
+        ChannelState* stateArray,
+        int numStages,
+        const Stage* trajectory,
+        int stride = 1)
+    {
+        typedef typename ChannelState::state_type_t StateType;
+        LaneGroups<typename LaneVectors<StateType>::native_t>::process(
+            numSamples, numChannels, sourceChannels, arrayOfChannels,
+            stateArray, numStages, StageTrajectory<Stage>(trajectory, numStages),
+            stride);
+    }
+
+    // Process a block of one channel out of place through a state that
+    // only works in place: the source is converted into dest a chunk at a
+    // time and processed there while it is still in the cache.
+    template <class StateType, class FilterClass, typename Source, typename Sample>
+    void processFrom(int numSamples,
+        const Source* src,
+        Sample* dest,
+        StateType& state,
+        const FilterClass& filter)
+    {
+        const int chunkSamples = 256;
+
+        for (int offset = 0; offset < numSamples; offset += chunkSamples)
+        {
+            const int count = std::min(chunkSamples, numSamples - offset);
+
+            for (int n = 0; n < count; ++n)
+                dest[offset + n] = static_cast<Sample>(src[offset + n]);
+
+            state.process(count, dest + offset, filter);
+        }
+    }
+
+    // Process interleaved frames in place: sample n of channel i is at
+    // frames[n * frameStride + i]. frameStride is usually numChannels but
+    // may be larger to skip channels that are not processed.
+    template <class ChannelState, class Stage, typename Sample>
+    void processFrames(int numSamples,
+        int numChannels,
+        Sample* frames,
+        int frameStride,
+        ChannelState* stateArray,
+        int numStages,
+        const Stage* stageArray)
+    {
+        assert(numChannels <= frameStride);
+
+        // a multiple of every lane count
+        const int batchChannels = 16;
+        Sample* channels[batchChannels];
+
+        for (int first = 0; first < numChannels; first += batchChannels)
+        {
+            const int count = std::min(batchChannels, numChannels - first);
+            for (int i = 0; i < count; ++i)
+                channels[i] = frames + first + i;
+
+            processChannels(numSamples, count, channels, stateArray + first,
+                numStages, stageArray, frameStride);
+        }
+    }
+
+    // Process interleaved frames in place one channel at a time, through
+    // a scratch buffer, for states that only process a single channel.
+    template <class ChannelState, class FilterClass, typename Sample>
+    void processFramesByChannel(int numSamples,
+        int numChannels,
+        Sample* frames,
+        int frameStride,
+        ChannelState* stateArray,
+        const FilterClass& filter)
+    {
+        const int chunkSamples = 256;
+        Sample data[chunkSamples];
+
+        for (int i = 0; i < numChannels; ++i)
+        {
+            for (int offset = 0; offset < numSamples; offset += chunkSamples)
+            {
+                const int count = std::min(chunkSamples, numSamples - offset);
+                Sample* p = frames + offset * frameStride + i;
+
+                for (int n = 0; n < count; ++n)
+                    data[n] = p[n * frameStride];
+
+                stateArray[i].process(count, data, filter);
+
+                for (int n = 0; n < count; ++n)
+                    p[n * frameStride] = data[n];
+            }
+        }
+    }
+
+}
+
+#endif
@@ -0,0 +1,35 @@
+#include "pch.h"
+#include "Simd.h"
+
+// Built like the rest of the library, without -mavx or /arch:AVX. Only the
+// kernels are compiled for AVX, see DispatchKernels.h.
+#ifdef DSPFILTERS_SIMD_WIDE_KERNELS
+#  define DSPFILTERS_KERNEL_VECTOR Simd::Avx
+#  define DSPFILTERS_KERNEL_VECTOR_FLOAT Simd::AvxFloat
+#  define DSPFILTERS_KERNEL_TARGET DSPFILTERS_TARGET_AVX DSPFILTERS_FLATTEN \
+    DSPFILTERS_NO_CONTRACT
+#  include "DispatchKernels.h"
+#else
+#  include "Dispatch.h"
+#endif
+
+namespace Dsp {
+
+    namespace Dispatch {
+
+#ifdef DSPFILTERS_SIMD_WIDE_KERNELS
+        const KernelTable* getAvxKernels()
+        {
+            static const KernelTable table = makeKernelTable(targetAvx);
+            return &table;
+        }
+#else
+        const KernelTable* getAvxKernels()
+        {
+            return 0;
+        }
+#endif
+
+    }
+
+}
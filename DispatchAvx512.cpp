@@ -0,0 +1,34 @@
+#include "pch.h"
+#include "Simd.h"
+
+// See DispatchAvx.cpp, this file needs no switches either.
+#ifdef DSPFILTERS_SIMD_WIDE_KERNELS
+#  define DSPFILTERS_KERNEL_VECTOR Simd::Avx512
+#  define DSPFILTERS_KERNEL_VECTOR_FLOAT Simd::Avx512Float
+#  define DSPFILTERS_KERNEL_TARGET DSPFILTERS_TARGET_AVX512 DSPFILTERS_FLATTEN \
+    DSPFILTERS_NO_CONTRACT
+#  include "DispatchKernels.h"
+#else
+#  include "Dispatch.h"
+#endif
+
+namespace Dsp {
+
+    namespace Dispatch {
+
+#ifdef DSPFILTERS_SIMD_WIDE_KERNELS
+        const KernelTable* getAvx512Kernels()
+        {
+            static const KernelTable table = makeKernelTable(targetAvx512);
+            return &table;
+        }
+#else
+        const KernelTable* getAvx512Kernels()
+        {
+            return 0;
+        }
+#endif
+
+    }
+
+}
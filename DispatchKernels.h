@@ -0,0 +1,212 @@
+#ifndef DSPFILTERS_DISPATCHKERNELS_H
+#define DSPFILTERS_DISPATCHKERNELS_H
+
+#include "Common.h"
+#include "Cascade.h"
+#include "Dispatch.h"
+#include "State.h"
+
+/*@Internal*/
+// Body of the kernel translation units. Each of DispatchSse2.cpp,
+// DispatchAvx.cpp and DispatchAvx512.cpp includes this once, after
+// defining
+//
+//   DSPFILTERS_KERNEL_VECTOR        the double precision vector type
+//   DSPFILTERS_KERNEL_VECTOR_FLOAT  the single precision vector type
+//   DSPFILTERS_KERNEL_TARGET        attributes of the kernel functions
+//
+// The files are built with the flags of the rest of the library. Only the
+// kernels below, which have internal linkage, are compiled for the wider
+// instruction set: the lane templates they use are inlined into them
+// (flatten), and the vector wrappers carry the target attribute. Shared
+// inline code, which the linker may take from any translation unit, stays
+// on the baseline instruction set. Left-over channels go back to the
+// caller so that no narrower vector is needed here.
+
+namespace Dsp {
+
+    namespace Dispatch {
+
+        namespace {
+
+            // The vector type of this file for values of the given precision
+            template <typename Value>
+            struct KernelVector
+            {
+                typedef DSPFILTERS_KERNEL_VECTOR type;
+            };
+
+            template <>
+            struct KernelVector <float>
+            {
+                typedef DSPFILTERS_KERNEL_VECTOR_FLOAT type;
+            };
+
+            template <typename Sample, class StateType, class Stage>
+            DSPFILTERS_KERNEL_TARGET int channelKernel(int numSamples,
+                int numChannels,
+                const Sample* const* sourceChannels,
+                Sample* const* arrayOfChannels,
+                ChannelRef<StateType>* stateArray,
+                int numStages,
+                const Stage* stageArray,
+                int stride)
+            {
+                typedef typename KernelVector<typename StateType::value_type>::type Vec;
+
+                int done = 0;
+                for (; numChannels - done >= Vec::lanes; done += Vec::lanes)
+                {
+                    StateType* states[Vec::lanes];
+                    DenormalPrevention* denormals[Vec::lanes];
+                    for (int i = 0; i < Vec::lanes; ++i)
+                    {
+                        states[i] = stateArray[done + i].getStateArray();
+                        denormals[i] = &stateArray[done + i].getDenormalPrevention();
+                    }
+
+                    processLanes<Vec>(numSamples, numStages, stageArray,
+                        sourceChannels + done, arrayOfChannels + done,
+                        states, denormals, stride);
+                }
+
+                return done;
+            }
+
+            template <typename Sample, class Stage>
+            DSPFILTERS_KERNEL_TARGET bool skewedKernel(int numSamples,
+                Sample* dest,
+                int numStages,
+                const Stage* stageArray,
+                SkewedDirectFormII* stateArray,
+                DenormalPrevention& denormal)
+            {
+                return SkewedPipeline<KernelVector<double>::type>::process(numSamples, dest,
+                    numStages, stageArray, stateArray, denormal);
+            }
+
+            template <typename Value>
+            DSPFILTERS_KERNEL_TARGET void addKernel(int samples, Value* dest, const Value* src)
+            {
+                typedef typename KernelVector<Value>::type Vec;
+
+                for (; samples >= Vec::lanes; samples -= Vec::lanes)
+                {
+                    (Vec::load(dest) + Vec::load(src)).store(dest);
+                    dest += Vec::lanes;
+                    src += Vec::lanes;
+                }
+
+                while (--samples >= 0)
+                    *dest++ += *src++;
+            }
+
+            template <typename Value>
+            DSPFILTERS_KERNEL_TARGET void multiplyKernel(int samples, Value* dest, Value factor)
+            {
+                typedef typename KernelVector<Value>::type Vec;
+
+                const Vec f = Vec::broadcast(factor);
+                for (; samples >= Vec::lanes; samples -= Vec::lanes)
+                {
+                    (Vec::load(dest) * f).store(dest);
+                    dest += Vec::lanes;
+                }
+
+                while (--samples >= 0)
+                    *dest++ *= factor;
+            }
+
+            DSPFILTERS_KERNEL_TARGET int responseKernel(int count,
+                const double* cosines,
+                const double* sines,
+                int numStages,
+                const BiquadCoefficients<double>* stageArray,
+                double* real,
+                double* imag,
+                double* power)
+            {
+                return responseLanes<KernelVector<double>::type>(count, cosines, sines,
+                    numStages, stageArray, real, imag, power);
+            }
+
+            DSPFILTERS_KERNEL_TARGET int magnitudeKernel(int count,
+                const double* cosines,
+                const double* sines,
+                int numStages,
+                const BiquadCoefficients<double>* stageArray,
+                double* numerator,
+                double* denominator)
+            {
+                return magnitudeLanes<KernelVector<double>::type>(count, cosines, sines,
+                    numStages, stageArray, numerator, denominator);
+            }
+
+            //------------------------------------------------------------------------------
+
+            template <typename Sample, class StateType, class Stage>
+            void setChannelKernel(KernelTable& table)
+            {
+                typedef typename ChannelKernel<Sample, StateType, Stage>::Type Kernel;
+
+                const Kernel kernel = &channelKernel<Sample, StateType, Stage>;
+                table.channels
+                    [SampleIndex<Sample>::value]
+                    [FormIndex<StateType>::value]
+                    [StageIndex<Stage>::value] = reinterpret_cast<Function>(kernel);
+            }
+
+            template <typename Sample, class StateType>
+            void setChannelKernels(KernelTable& table)
+            {
+                typedef BiquadCoefficients<typename StateType::value_type> Compiled;
+
+                setChannelKernel<Sample, StateType, BiquadBase>(table);
+                setChannelKernel<Sample, StateType, Compiled>(table);
+            }
+
+            template <typename Sample>
+            void setSampleKernels(KernelTable& table)
+            {
+                setChannelKernels<Sample, DirectFormI>(table);
+                setChannelKernels<Sample, DirectFormII>(table);
+                setChannelKernels<Sample, TransposedDirectFormII>(table);
+                setChannelKernels<Sample, DirectFormIFloat>(table);
+                setChannelKernels<Sample, DirectFormIIFloat>(table);
+                setChannelKernels<Sample, TransposedDirectFormIIFloat>(table);
+
+                const typename SkewedKernel<Sample, BiquadBase>::Type biquad =
+                    &skewedKernel<Sample, BiquadBase>;
+                const typename SkewedKernel<Sample, BiquadCoefficients<double> >::Type
+                    compiled = &skewedKernel<Sample, BiquadCoefficients<double> >;
+                table.skewed[SampleIndex<Sample>::value]
+                    [StageIndex<BiquadBase>::value] = reinterpret_cast<Function>(biquad);
+                table.skewed[SampleIndex<Sample>::value]
+                    [StageIndex<BiquadCoefficients<double> >::value] =
+                    reinterpret_cast<Function>(compiled);
+            }
+
+            KernelTable makeKernelTable(Target target)
+            {
+                KernelTable table;
+
+                table.target = target;
+                setSampleKernels<float>(table);
+                setSampleKernels<double>(table);
+                table.addFloat = &addKernel<float>;
+                table.addDouble = &addKernel<double>;
+                table.multiplyFloat = &multiplyKernel<float>;
+                table.multiplyDouble = &multiplyKernel<double>;
+                table.response = &responseKernel;
+                table.magnitude = &magnitudeKernel;
+
+                return table;
+            }
+
+        }
+
+    }
+
+}
+
+#endif
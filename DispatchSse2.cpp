@@ -0,0 +1,33 @@
+#include "pch.h"
+#include "Simd.h"
+
+// SSE2 is part of every x64 processor, so these kernels need no target.
+#ifdef DSPFILTERS_SIMD_SSE2
+#  define DSPFILTERS_KERNEL_VECTOR Simd::Sse2
+#  define DSPFILTERS_KERNEL_VECTOR_FLOAT Simd::Sse2Float
+#  define DSPFILTERS_KERNEL_TARGET DSPFILTERS_NO_CONTRACT
+#  include "DispatchKernels.h"
+#else
+#  include "Dispatch.h"
+#endif
+
+namespace Dsp {
+
+    namespace Dispatch {
+
+#ifdef DSPFILTERS_SIMD_SSE2
+        const KernelTable* getSse2Kernels()
+        {
+            static const KernelTable table = makeKernelTable(targetSse2);
+            return &table;
+        }
+#else
+        const KernelTable* getSse2Kernels()
+        {
+            return 0;
+        }
+#endif
+
+    }
+
+}
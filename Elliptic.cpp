@@ -286,6 +286,11 @@ namespace Dsp {
             double rippleDb,
             double rolloff)
         {
+            const DesignCache::Key key(DesignCache::familyElliptic, kindLowPass, order,
+                cutoffFrequency / sampleRate, 0, 0, rippleDb, rolloff);
+            if (DesignCache::load(key, *this))
+                return;
+
             m_analogProto.design(order, rippleDb, rolloff);
 
             LowPassTransform(cutoffFrequency / sampleRate,
@@ -293,6 +298,8 @@ namespace Dsp {
                 m_analogProto);
 
             Cascade::setLayout(m_digitalProto);
+
+            DesignCache::store(key, *this);
         }
 
         void HighPassBase::setup(int order,
@@ -301,6 +308,11 @@ namespace Dsp {
             double rippleDb,
             double rolloff)
         {
+            const DesignCache::Key key(DesignCache::familyElliptic, kindHighPass, order,
+                cutoffFrequency / sampleRate, 0, 0, rippleDb, rolloff);
+            if (DesignCache::load(key, *this))
+                return;
+
             m_analogProto.design(order, rippleDb, rolloff);
 
             HighPassTransform(cutoffFrequency / sampleRate,
@@ -308,6 +320,8 @@ namespace Dsp {
                 m_analogProto);
 
             Cascade::setLayout(m_digitalProto);
+
+            DesignCache::store(key, *this);
         }
 
         void BandPassBase::setup(int order,
@@ -317,6 +331,12 @@ namespace Dsp {
             double rippleDb,
             double rolloff)
         {
+            const DesignCache::Key key(DesignCache::familyElliptic, kindBandPass, order,
+                centerFrequency / sampleRate, widthFrequency / sampleRate, 0,
+                rippleDb, rolloff);
+            if (DesignCache::load(key, *this))
+                return;
+
             m_analogProto.design(order, rippleDb, rolloff);
 
             BandPassTransform(centerFrequency / sampleRate,
@@ -325,6 +345,8 @@ namespace Dsp {
                 m_analogProto);
 
             Cascade::setLayout(m_digitalProto);
+
+            DesignCache::store(key, *this);
         }
 
         void BandStopBase::setup(int order,
@@ -334,6 +356,12 @@ namespace Dsp {
             double rippleDb,
             double rolloff)
         {
+            const DesignCache::Key key(DesignCache::familyElliptic, kindBandStop, order,
+                centerFrequency / sampleRate, widthFrequency / sampleRate, 0,
+                rippleDb, rolloff);
+            if (DesignCache::load(key, *this))
+                return;
+
             m_analogProto.design(order, rippleDb, rolloff);
 
             BandStopTransform(centerFrequency / sampleRate,
@@ -342,6 +370,8 @@ namespace Dsp {
                 m_analogProto);
 
             Cascade::setLayout(m_digitalProto);
+
+            DesignCache::store(key, *this);
         }
 
     }
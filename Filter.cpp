@@ -4,6 +4,74 @@
 
 namespace Dsp {
 
+    namespace {
+
+        // Point index of numFrequencies from first to last
+        double gridFrequency(double first,
+            double last,
+            int numFrequencies,
+            Spacing spacing,
+            int index)
+        {
+            if (numFrequencies < 2)
+                return first;
+
+            const double t = double(index) / (numFrequencies - 1);
+            if (spacing == spacingLogarithmic)
+                return first * std::pow(last / first, t);
+            else
+                return first + t * (last - first);
+        }
+
+        double decibels(const complex_t& response)
+        {
+            return 10 * std::log10(std::norm(response));
+        }
+
+        template <typename Sample>
+        void processFrames(Filter& filter,
+            int numSamples,
+            Sample* frames,
+            int frameStride)
+        {
+            const int numChannels = filter.getNumChannels();
+            assert(frameStride >= numChannels);
+            if (numChannels < 1 || numSamples < 1)
+                return;
+
+            std::vector<Sample> scratch(numChannels * numSamples);
+            std::vector<Sample*> channels(numChannels);
+            for (int i = 0; i < numChannels; ++i)
+            {
+                channels[i] = &scratch[i * numSamples];
+                for (int n = 0; n < numSamples; ++n)
+                    channels[i][n] = frames[n * frameStride + i];
+            }
+
+            filter.process(numSamples, &channels[0]);
+
+            for (int i = 0; i < numChannels; ++i)
+                for (int n = 0; n < numSamples; ++n)
+                    frames[n * frameStride + i] = channels[i][n];
+        }
+
+        template <typename Sample>
+        void processFrom(Filter& filter,
+            int numSamples,
+            const Sample* const* sourceChannels,
+            Sample* const* arrayOfChannels)
+        {
+            const int numChannels = filter.getNumChannels();
+            for (int i = 0; i < numChannels; ++i)
+                if (arrayOfChannels[i] != sourceChannels[i])
+                    std::copy(sourceChannels[i], sourceChannels[i] + numSamples,
+                        arrayOfChannels[i]);
+
+            filter.process(numSamples, arrayOfChannels);
+        }
+
+    }
+
     Params Filter::getDefaultParams() const
     {
         Params params;
@@ -20,6 +88,78 @@ namespace Dsp {
     {
     }
 
+    int Filter::getPoleZeros(PoleZeroPair* pairs, int maxPairs) const
+    {
+        const std::vector<PoleZeroPair> vpz = getPoleZeros();
+        const int numPairs = static_cast<int>(vpz.size());
+        const int count = std::min(numPairs, maxPairs);
+        for (int i = 0; i < count; ++i)
+            pairs[i] = vpz[i];
+        return numPairs;
+    }
+
+    void Filter::responseGrid(const double* normalizedFrequencies,
+        int numFrequencies,
+        complex_t* response) const
+    {
+        for (int i = 0; i < numFrequencies; ++i)
+            response[i] = this->response(normalizedFrequencies[i]);
+    }
+
+    void Filter::responseGrid(double first,
+        double last,
+        int numFrequencies,
+        Spacing spacing,
+        complex_t* response) const
+    {
+        for (int i = 0; i < numFrequencies; ++i)
+            response[i] = this->response(
+                gridFrequency(first, last, numFrequencies, spacing, i));
+    }
+
+    void Filter::magnitudeDbGrid(const double* normalizedFrequencies,
+        int numFrequencies,
+        double* magnitudeDb) const
+    {
+        for (int i = 0; i < numFrequencies; ++i)
+            magnitudeDb[i] = decibels(response(normalizedFrequencies[i]));
+    }
+
+    void Filter::magnitudeDbGrid(double first,
+        double last,
+        int numFrequencies,
+        Spacing spacing,
+        double* magnitudeDb) const
+    {
+        for (int i = 0; i < numFrequencies; ++i)
+            magnitudeDb[i] = decibels(response(
+                gridFrequency(first, last, numFrequencies, spacing, i)));
+    }
+
+    void Filter::process(int numSamples, float* frames, int frameStride)
+    {
+        processFrames(*this, numSamples, frames, frameStride);
+    }
+
+    void Filter::process(int numSamples, double* frames, int frameStride)
+    {
+        processFrames(*this, numSamples, frames, frameStride);
+    }
+
+    void Filter::process(int numSamples,
+        const float* const* sourceChannels,
+        float* const* arrayOfChannels)
+    {
+        processFrom(*this, numSamples, sourceChannels, arrayOfChannels);
+    }
+
+    void Filter::process(int numSamples,
+        const double* const* sourceChannels,
+        double* const* arrayOfChannels)
+    {
+        processFrom(*this, numSamples, sourceChannels, arrayOfChannels);
+    }
+
     int Filter::findParamId(int paramId)
     {
         int index = -1;
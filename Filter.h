@@ -67,13 +67,56 @@ namespace Dsp {
 
         virtual std::vector<PoleZeroPair> getPoleZeros() const = 0;
 
+        // Copy up to maxPairs pairs into pairs and return how many there
+        // are in all; call with maxPairs = 0 to size the buffer. The
+        // filters here do not allocate, so it can be called while
+        // processing. The default copies from the vector version.
+        virtual int getPoleZeros(PoleZeroPair* pairs, int maxPairs) const;
+
         virtual complex_t response(double normalizedFrequency) const = 0;
 
+        // Responses at many frequencies, see Cascade::responseGrid. The
+        // filters here evaluate them in SIMD lanes; the defaults call
+        // response() at each frequency.
+        virtual void responseGrid(const double* normalizedFrequencies,
+            int numFrequencies,
+            complex_t* response) const;
+        virtual void responseGrid(double first,
+            double last,
+            int numFrequencies,
+            Spacing spacing,
+            complex_t* response) const;
+        virtual void magnitudeDbGrid(const double* normalizedFrequencies,
+            int numFrequencies,
+            double* magnitudeDb) const;
+        virtual void magnitudeDbGrid(double first,
+            double last,
+            int numFrequencies,
+            Spacing spacing,
+            double* magnitudeDb) const;
+
         virtual int getNumChannels() = 0;
         virtual void reset() = 0;
         virtual void process(int numSamples, float* const* arrayOfChannels) = 0;
         virtual void process(int numSamples, double* const* arrayOfChannels) = 0;
 
+        // Process interleaved frames in place. Sample n of channel i is
+        // frames[n * frameStride + i], with frameStride >= getNumChannels().
+        // The defaults copy the frames into planar scratch, which allocates,
+        // and call the planar process.
+        virtual void process(int numSamples, float* frames, int frameStride);
+        virtual void process(int numSamples, double* frames, int frameStride);
+
+        // Process out of place, leaving the source channels untouched.
+        // The output is identical to copying them over and processing,
+        // which is what the defaults do.
+        virtual void process(int numSamples,
+            const float* const* sourceChannels,
+            float* const* arrayOfChannels);
+        virtual void process(int numSamples,
+            const double* const* sourceChannels,
+            double* const* arrayOfChannels);
+
     protected:
         virtual void doSetParams(const Params& parameters) = 0;
 
@@ -83,6 +126,21 @@ namespace Dsp {
 
     //------------------------------------------------------------------------------
 
+    class Cascade;
+
+    // Has a design compile its stages for state forms of Value, see
+    // Cascade::setCompiledValueType. Other designs keep their
+    // coefficients in every precision.
+    template <typename Value>
+    void compileStagesFor(Cascade* design);
+
+    template <typename Value>
+    void compileStagesFor(const void*)
+    {
+    }
+
+    //------------------------------------------------------------------------------
+
     /*
      * FilterDesign
      *
@@ -139,11 +197,50 @@ namespace Dsp {
             return m_design.getPoleZeros();
         }
 
+        int getPoleZeros(PoleZeroPair* pairs, int maxPairs) const
+        {
+            return m_design.getPoleZeros(pairs, maxPairs);
+        }
+
         complex_t response(double normalizedFrequency) const
         {
             return m_design.response(normalizedFrequency);
         }
 
+        void responseGrid(const double* normalizedFrequencies,
+            int numFrequencies,
+            complex_t* response) const
+        {
+            m_design.responseGrid(normalizedFrequencies, numFrequencies, response);
+        }
+
+        void responseGrid(double first,
+            double last,
+            int numFrequencies,
+            Spacing spacing,
+            complex_t* response) const
+        {
+            m_design.responseGrid(first, last, numFrequencies, spacing, response);
+        }
+
+        void magnitudeDbGrid(const double* normalizedFrequencies,
+            int numFrequencies,
+            double* magnitudeDb) const
+        {
+            m_design.magnitudeDbGrid(normalizedFrequencies, numFrequencies,
+                magnitudeDb);
+        }
+
+        void magnitudeDbGrid(double first,
+            double last,
+            int numFrequencies,
+            Spacing spacing,
+            double* magnitudeDb) const
+        {
+            m_design.magnitudeDbGrid(first, last, numFrequencies, spacing,
+                magnitudeDb);
+        }
+
     protected:
         void doSetParams(const Params& parameters)
         {
@@ -158,17 +255,32 @@ namespace Dsp {
 
     template <class DesignClass,
         int Channels = 0,
-        class StateType = DirectFormII>
+        class StateType = DirectFormII,
+        class Denormal = DenormalPrevention>
         class FilterDesign : public FilterDesignBase <DesignClass>
     {
     public:
         FilterDesign()
         {
+            compileStagesFor<typename state_t::state_type_t::value_type>(
+                &this->m_design);
         }
 
         int getNumChannels()
         {
-            return Channels;
+            return m_state.getNumChannels();
+        }
+
+        // Only for Channels = dynamicChannels, resets every channel
+        void setNumChannels(int numChannels)
+        {
+            m_state.setNumChannels(numChannels);
+        }
+
+        // Process the channels in parallel, see ChannelExecutor
+        void setExecutor(ChannelExecutor* executor)
+        {
+            m_state.setExecutor(executor);
         }
 
         void reset()
@@ -176,6 +288,13 @@ namespace Dsp {
             m_state.reset();
         }
 
+        // Number of samples by which the output lags the input, which
+        // only the skewed form has (see SkewedDirectFormII)
+        int getLatency() const
+        {
+            return state_t::getLatency(FilterDesignBase<DesignClass>::m_design);
+        }
+
         void process(int numSamples, float* const* arrayOfChannels)
         {
             m_state.process(numSamples, arrayOfChannels,
@@ -188,9 +307,38 @@ namespace Dsp {
                 FilterDesignBase<DesignClass>::m_design);
         }
 
+        void process(int numSamples, float* frames, int frameStride)
+        {
+            m_state.process(numSamples, frames, frameStride,
+                FilterDesignBase<DesignClass>::m_design);
+        }
+
+        void process(int numSamples, double* frames, int frameStride)
+        {
+            m_state.process(numSamples, frames, frameStride,
+                FilterDesignBase<DesignClass>::m_design);
+        }
+
+        void process(int numSamples,
+            const float* const* sourceChannels,
+            float* const* arrayOfChannels)
+        {
+            m_state.process(numSamples, sourceChannels, arrayOfChannels,
+                FilterDesignBase<DesignClass>::m_design);
+        }
+
+        void process(int numSamples,
+            const double* const* sourceChannels,
+            double* const* arrayOfChannels)
+        {
+            m_state.process(numSamples, sourceChannels, arrayOfChannels,
+                FilterDesignBase<DesignClass>::m_design);
+        }
+
     protected:
-        ChannelsState <Channels,
-            typename DesignClass::template State <StateType> > m_state;
+        typedef typename DesignClass::template State <StateType, Denormal> state_t;
+
+        ChannelsState <Channels, state_t> m_state;
     };
 
     //------------------------------------------------------------------------------
@@ -204,13 +352,32 @@ namespace Dsp {
      */
     template <class FilterClass,
         int Channels = 0,
-        class StateType = DirectFormII>
+        class StateType = DirectFormII,
+        class Denormal = DenormalPrevention>
         class SimpleFilter : public FilterClass
     {
     public:
+        SimpleFilter()
+        {
+            compileStagesFor<typename state_t::state_type_t::value_type>(
+                static_cast<FilterClass*>(this));
+        }
+
         int getNumChannels()
         {
-            return Channels;
+            return m_state.getNumChannels();
+        }
+
+        // Only for Channels = dynamicChannels, resets every channel
+        void setNumChannels(int numChannels)
+        {
+            m_state.setNumChannels(numChannels);
+        }
+
+        // Process the channels in parallel, see ChannelExecutor
+        void setExecutor(ChannelExecutor* executor)
+        {
+            m_state.setExecutor(executor);
         }
 
         void reset()
@@ -218,15 +385,41 @@ namespace Dsp {
             m_state.reset();
         }
 
+        // Number of samples by which the output lags the input, which
+        // only the skewed form has (see SkewedDirectFormII)
+        int getLatency() const
+        {
+            return state_t::getLatency(*static_cast<const FilterClass*>(this));
+        }
+
         template <typename Sample>
         void process(int numSamples, Sample* const* arrayOfChannels)
         {
             m_state.process(numSamples, arrayOfChannels, *((FilterClass*)this));
         }
 
+        // Process interleaved frames, see Filter::process
+        template <typename Sample>
+        void process(int numSamples, Sample* frames, int frameStride)
+        {
+            m_state.process(numSamples, frames, frameStride,
+                *((FilterClass*)this));
+        }
+
+        // Process out of place, converting from the source sample type
+        template <typename Source, typename Sample>
+        void process(int numSamples,
+            const Source* const* sourceChannels,
+            Sample* const* arrayOfChannels)
+        {
+            m_state.process(numSamples, sourceChannels, arrayOfChannels,
+                *((FilterClass*)this));
+        }
+
     protected:
-        ChannelsState <Channels,
-            typename FilterClass::template State <StateType> > m_state;
+        typedef typename FilterClass::template State <StateType, Denormal> state_t;
+
+        ChannelsState <Channels, state_t> m_state;
     };
 
 }
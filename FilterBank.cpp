@@ -0,0 +1,73 @@
+#include "pch.h"
+#include "Common.h"
+#include "FilterBank.h"
+
+namespace Dsp {
+
+    FilterBank::FilterBank()
+        : m_numBands(0)
+        , m_maxBands(0)
+        , m_maxStages(0)
+        , m_stageArray(0)
+        , m_numStagesArray(0)
+    {
+    }
+
+    void FilterBank::setBankStorage(int maxBands,
+        int maxStages,
+        Cascade::Stage* stageArray,
+        int* numStagesArray)
+    {
+        m_numBands = 0;
+        m_maxBands = maxBands;
+        m_maxStages = maxStages;
+        m_stageArray = stageArray;
+        m_numStagesArray = numStagesArray;
+    }
+
+    complex_t FilterBank::response(int band, double normalizedFrequency) const
+    {
+        complex_t ch(1);
+
+        for (int i = 0; i < getNumStages(band); ++i)
+            ch *= getStage(band, i).response(normalizedFrequency);
+
+        return ch;
+    }
+
+    void FilterBank::setNumBands(int numBands)
+    {
+        assert(numBands >= 0 && numBands <= m_maxBands);
+
+        for (int band = m_numBands; band < numBands; ++band)
+        {
+            m_stageArray[band * m_maxStages].setCoefficients(1, 0, 0, 1, 0, 0);
+            m_numStagesArray[band] = 1;
+        }
+
+        m_numBands = numBands;
+    }
+
+    void FilterBank::setBand(int band, const Cascade& cascade)
+    {
+        assert(band >= 0 && band < m_numBands);
+
+        const int numStages = cascade.getNumStages();
+        assert(numStages > 0 && numStages <= m_maxStages);
+
+        Cascade::Stage* stage = m_stageArray + band * m_maxStages;
+        for (int i = 0; i < numStages; ++i)
+            stage[i] = cascade[i];
+
+        m_numStagesArray[band] = numStages;
+    }
+
+    void FilterBank::setBand(int band, const BiquadBase& biquad)
+    {
+        assert(band >= 0 && band < m_numBands);
+
+        static_cast<BiquadBase&>(m_stageArray[band * m_maxStages]) = biquad;
+        m_numStagesArray[band] = 1;
+    }
+
+}
@@ -0,0 +1,434 @@
+#ifndef DSPFILTERS_FILTERBANK_H
+#define DSPFILTERS_FILTERBANK_H
+
+#include "Common.h"
+#include "Biquad.h"
+#include "Cascade.h"
+#include "MathSupplement.h"
+#include "Simd.h"
+
+namespace Dsp {
+
+    // Samples processBands works through at a time, and so the most a sink
+    // is given between begin() and end()
+    enum
+    {
+        bandChunkSamples = 64
+    };
+
+    // Process a block of one input through a bank of cascades, band b in
+    // lane b % Vec::lanes of group b / Vec::lanes, each lane with its own
+    // sections. Bands shorter than the longest in their group are padded
+    // with pass-through sections, and lanes past the last band run on
+    // spare states. Every chunk of output goes to the sink, which stores,
+    // measures or mixes it.
+    template <class Vec, class StateType, class Stage, typename Sample, class Sink>
+    void processBands(int numSamples,
+        const Sample* src,
+        int numBands,
+        int maxStages,
+        const int* numStagesArray,
+        const Stage* stageArray,
+        StateType* stateArray,
+        DenormalPrevention& denormal,
+        Sink& sink)
+    {
+        typedef typename Vec::value_type value_type;
+
+        enum
+        {
+            lanes = Vec::lanes,
+            chunkSamples = bandChunkSamples,
+            groupStages = 16
+        };
+
+        Biquad passStage;
+        passStage.setCoefficients(1, 0, 0, 1, 0, 0);
+        StateType spare[lanes][groupStages];
+
+        LaneBiquad<Vec> section[groupStages];
+        LaneState<StateType, Vec> state[groupStages];
+
+        Vec in[chunkSamples];
+        Vec out[chunkSamples];
+        const Vec zero = Vec::broadcast(0);
+
+        double ac = denormal.getAc();
+        for (int offset = 0; offset < numSamples; offset += chunkSamples)
+        {
+            const int count = std::min(int(chunkSamples), numSamples - offset);
+
+            for (int n = 0; n < count; ++n)
+                in[n] = Vec::broadcast(static_cast<value_type>(
+                    static_cast<Sample>(src[offset + n])));
+
+            sink.begin(count);
+
+            for (int first = 0; first < numBands; first += lanes)
+            {
+                int numStages = 0;
+                for (int i = 0; i < lanes && first + i < numBands; ++i)
+                    numStages = std::max(numStages, numStagesArray[first + i]);
+
+                // Very long cascades are run in groups of groupStages
+                for (int k = 0; k < numStages; k += groupStages)
+                {
+                    const int stages = std::min(int(groupStages), numStages - k);
+
+                    StateType* states[lanes];
+                    for (int i = 0; i < lanes; ++i)
+                    {
+                        const int b = first + i;
+                        states[i] = b < numBands ?
+                            stateArray + b * maxStages + k : spare[i];
+                    }
+
+                    for (int j = 0; j < stages; ++j)
+                    {
+                        const BiquadBase* sections[lanes];
+                        for (int i = 0; i < lanes; ++i)
+                        {
+                            const int b = first + i;
+                            if (b < numBands && k + j < numStagesArray[b])
+                                sections[i] = &stageArray[b * maxStages + k + j];
+                            else
+                                sections[i] = &passStage;
+                        }
+                        section[j].setLanes(sections);
+                        state[j].load(states, j);
+                    }
+
+                    double v = ac;
+                    for (int n = 0; n < count; ++n)
+                    {
+                        Vec x = k == 0 ? in[n] : out[n];
+                        int j = 0;
+                        if (k == 0)
+                        {
+                            v = -v;
+                            x = state[0].process1(x, section[0],
+                                Vec::broadcast(static_cast<value_type>(v)));
+                            ++j;
+                        }
+                        for (; j < stages; ++j)
+                            x = state[j].process1(x, section[j], zero);
+                        out[n] = x;
+                    }
+
+                    for (int j = 0; j < stages; ++j)
+                        state[j].store(states, j);
+                }
+
+                sink.consume(first, count, offset, out);
+            }
+
+            sink.end(count, offset);
+
+            if (count & 1)
+                ac = -ac;
+        }
+
+        denormal.setAc(ac);
+    }
+
+    //------------------------------------------------------------------------------
+
+    /*
+     * Runs a bank of filters over one shared input, such as the bands of
+     * an octave or third octave analyzer.
+     *
+     * Each band holds the sections of a designed Cascade or a single
+     * Biquad. The bands are spread across SIMD lanes with their own
+     * coefficients, so each chunk of input is read once for a whole group
+     * of bands instead of once per filter. The output can be a buffer per
+     * band, the energy of each band, or a weighted mix of the bands. Each
+     * band's output is identical to processing it as a Cascade on its own.
+     *
+     */
+
+     // Factored interface, see FilterBankStages for storage
+    class FilterBank
+    {
+    public:
+        template <class StateType, class Denormal = DenormalPrevention>
+        class StateBase : private Denormal
+        {
+        public:
+            typedef StateType state_type_t;
+            typedef Denormal denormal_t;
+
+            /*@Internal*/
+            StateType* getStateArray()
+            {
+                return m_stateArray;
+            }
+
+            /*@Internal*/
+            DenormalPrevention& getDenormalPrevention()
+            {
+                return *this;
+            }
+
+        protected:
+            StateBase(StateType* stateArray)
+                : m_stateArray(stateArray)
+            {
+            }
+
+        protected:
+            StateType* m_stateArray;
+        };
+
+    public:
+        int getNumBands() const
+        {
+            return m_numBands;
+        }
+
+        int getNumStages(int band) const
+        {
+            assert(band >= 0 && band < m_numBands);
+            return m_numStagesArray[band];
+        }
+
+        const Cascade::Stage& getStage(int band, int index) const
+        {
+            assert(index >= 0 && index < getNumStages(band));
+            return m_stageArray[band * m_maxStages + index];
+        }
+
+        // Calculate the response of a band at the given normalized frequency.
+        complex_t response(int band, double normalizedFrequency) const;
+
+        // Set the number of bands, which start out as pass-through
+        void setNumBands(int numBands);
+
+        // Copy the sections of a designed filter into a band
+        void setBand(int band, const Cascade& cascade);
+        void setBand(int band, const BiquadBase& biquad);
+
+        // Process one input into a buffer per band
+        template <class StateType, typename Sample>
+        void process(int numSamples,
+            const Sample* src,
+            Sample* const* bandOutputs,
+            StateType& state) const
+        {
+            Outputs<Sample> sink(bandOutputs, m_numBands);
+            processInto(numSamples, src, state, sink);
+        }
+
+        // Process one input and add the sum of the squared outputs of
+        // each band to bandEnergy
+        template <class StateType, typename Sample>
+        void processEnergy(int numSamples,
+            const Sample* src,
+            double* bandEnergy,
+            StateType& state) const
+        {
+            Energy sink(bandEnergy, m_numBands);
+            processInto(numSamples, src, state, sink);
+        }
+
+        // Process one input into the sum of the bands, each weighted by
+        // its entry in gains, or all by one if gains is 0. dest may be src.
+        template <class StateType, typename Sample>
+        void processMix(int numSamples,
+            const Sample* src,
+            Sample* dest,
+            StateType& state,
+            const double* gains = 0) const
+        {
+            Mix<Sample> sink(dest, gains, m_numBands);
+            processInto(numSamples, src, state, sink);
+        }
+
+    protected:
+        FilterBank();
+
+        void setBankStorage(int maxBands,
+            int maxStages,
+            Cascade::Stage* stageArray,
+            int* numStagesArray);
+
+    private:
+        template <class StateType, typename Sample, class Sink>
+        void processInto(int numSamples,
+            const Sample* src,
+            StateType& state,
+            Sink& sink) const
+        {
+            typedef typename StateType::state_type_t Form;
+
+            typename StateType::denormal_t::Scope scope;
+            processBands<typename LaneVectors<Form>::native_t>(numSamples, src,
+                m_numBands, m_maxStages, m_numStagesArray, m_stageArray,
+                state.getStateArray(), state.getDenormalPrevention(), sink);
+        }
+
+        // Sinks for processBands
+
+        template <typename Sample>
+        struct Outputs
+        {
+            Outputs(Sample* const* outputs_, int numBands_)
+                : outputs(outputs_)
+                , numBands(numBands_)
+            {
+            }
+
+            void begin(int)
+            {
+            }
+
+            template <class Vec>
+            void consume(int first, int count, int offset, const Vec* out)
+            {
+                typename Vec::value_type t[Vec::lanes];
+                const int lanes = std::min(int(Vec::lanes), numBands - first);
+                for (int n = 0; n < count; ++n)
+                {
+                    out[n].store(t);
+                    for (int i = 0; i < lanes; ++i)
+                        outputs[first + i][offset + n] = static_cast<Sample>(t[i]);
+                }
+            }
+
+            void end(int, int)
+            {
+            }
+
+            Sample* const* outputs;
+            int numBands;
+        };
+
+        struct Energy
+        {
+            Energy(double* energy_, int numBands_)
+                : energy(energy_)
+                , numBands(numBands_)
+            {
+            }
+
+            void begin(int)
+            {
+            }
+
+            template <class Vec>
+            void consume(int first, int count, int offset, const Vec* out)
+            {
+                typename Vec::value_type t[Vec::lanes];
+                double sum[Vec::lanes] = { 0 };
+                for (int n = 0; n < count; ++n)
+                {
+                    out[n].store(t);
+                    for (int i = 0; i < Vec::lanes; ++i)
+                        sum[i] += double(t[i]) * t[i];
+                }
+
+                const int lanes = std::min(int(Vec::lanes), numBands - first);
+                for (int i = 0; i < lanes; ++i)
+                    energy[first + i] += sum[i];
+            }
+
+            void end(int, int)
+            {
+            }
+
+            double* energy;
+            int numBands;
+        };
+
+        template <typename Sample>
+        struct Mix
+        {
+            Mix(Sample* dest_, const double* gains_, int numBands_)
+                : dest(dest_)
+                , gains(gains_)
+                , numBands(numBands_)
+            {
+            }
+
+            void begin(int count)
+            {
+                assert(count <= bandChunkSamples);
+                for (int n = 0; n < count; ++n)
+                    mix[n] = 0;
+            }
+
+            template <class Vec>
+            void consume(int first, int count, int offset, const Vec* out)
+            {
+                typename Vec::value_type t[Vec::lanes];
+                const int lanes = std::min(int(Vec::lanes), numBands - first);
+                for (int n = 0; n < count; ++n)
+                {
+                    out[n].store(t);
+                    double y = mix[n];
+                    for (int i = 0; i < lanes; ++i)
+                        y += (gains ? gains[first + i] : 1.) * t[i];
+                    mix[n] = y;
+                }
+            }
+
+            void end(int count, int offset)
+            {
+                for (int n = 0; n < count; ++n)
+                    dest[offset + n] = static_cast<Sample>(mix[n]);
+            }
+
+            Sample* dest;
+            const double* gains;
+            int numBands;
+            double mix[bandChunkSamples];
+        };
+
+    private:
+        int m_numBands;
+        int m_maxBands;
+        int m_maxStages;
+        Cascade::Stage* m_stageArray;
+        int* m_numStagesArray;
+    };
+
+    //------------------------------------------------------------------------------
+
+    // Storage for FilterBank
+    template <int MaxBands, int MaxStages>
+    class FilterBankStages : public FilterBank
+    {
+    public:
+        template <class StateType, class Denormal = DenormalPrevention>
+        class State : public FilterBank::StateBase <StateType, Denormal>
+        {
+        public:
+            State() : FilterBank::StateBase <StateType, Denormal>(m_states)
+            {
+                FilterBank::StateBase <StateType, Denormal>::m_stateArray = m_states;
+                reset();
+            }
+
+            void reset()
+            {
+                StateType* state = m_states;
+                for (int i = MaxBands * MaxStages; --i >= 0; ++state)
+                    state->reset();
+            }
+
+        private:
+            StateType m_states[MaxBands * MaxStages];
+        };
+
+        FilterBankStages()
+        {
+            setBankStorage(MaxBands, MaxStages, m_stages, m_numStages);
+        }
+
+    private:
+        Cascade::Stage m_stages[MaxBands * MaxStages];
+        int m_numStages[MaxBands];
+    };
+
+}
+
+#endif
@@ -106,6 +106,19 @@ namespace Dsp {
             m_normalGain = g;
         }
 
+        // Replace the poles, zeros and normalization with those of
+        // another layout, keeping this one's storage
+        void assign(int numPoles,
+            const PoleZeroPair* pairs,
+            double normalW,
+            double normalGain)
+        {
+            assert(numPoles <= m_maxPoles);
+            m_numPoles = numPoles;
+            std::copy(pairs, pairs + (numPoles + 1) / 2, m_pair);
+            setNormal(normalW, normalGain);
+        }
+
     private:
         int m_numPoles;
         int m_maxPoles;
@@ -194,6 +194,225 @@ namespace Dsp {
 
         //------------------------------------------------------------------------------
 
+        // The poles of orders 1 to tableOrders, found in double-double
+        // arithmetic and printed to 17 digits by Tests/PoleTables.cpp, which
+        // also checks them. Solving in double loses about a digit every
+        // order, to 1e-3 at order 25, so the table is the more accurate;
+        // higher orders are still solved. Each order lists one pole of each
+        // conjugate pair, then the real pole of an odd order.
+
+        static const int tableOrders = 25;
+
+        static const complex_t poleTable[] =
+        {
+            // order 1
+            complex_t(-1, 0),
+            // order 2
+            complex_t(-0.70710678118654757, 0.70710678118654757),
+            // order 3
+            complex_t(-0.34518561903119699, 0.90086563551837806),
+            complex_t(-0.62033181713012375, 0),
+            // order 4
+            complex_t(-0.23168872267885143, 0.94551066390267346),
+            complex_t(-0.54974342384548136, 0.35857181622501044),
+            // order 5
+            complex_t(-0.1535867376030384, 0.96814640778342964),
+            complex_t(-0.38813985178488669, 0.58863233806815574),
+            complex_t(-0.46808987558460169, 0),
+            // order 6
+            complex_t(-0.11519267902622141, 0.97792223447142834),
+            complex_t(-0.3089608853059938, 0.69816746281444486),
+            complex_t(-0.43890154955987659, 0.23998135208805685),
+            // order 7
+            complex_t(-0.08620854829124476, 0.98436980671134311),
+            complex_t(-0.23743975723791763, 0.77830089224056886),
+            complex_t(-0.34923178487245848, 0.42899611671748988),
+            complex_t(-0.38210331509996259, 0),
+            // order 8
+            complex_t(-0.068942157619263172, 0.98797096806029694),
+            complex_t(-0.19427588132916143, 0.82476672454114308),
+            complex_t(-0.30028400490128065, 0.54104224539113277),
+            complex_t(-0.36717631012214225, 0.18087919953768955),
+            // order 9
+            complex_t(-0.055097156647131426, 0.99066032534171289),
+            complex_t(-0.15728376902610011, 0.86134285062151128),
+            complex_t(-0.2485528956868289, 0.63381961998608638),
+            complex_t(-0.3093854331060566, 0.33654323712733547),
+            complex_t(-0.32568782235818566, 0),
+            // order 10
+            complex_t(-0.04590098260620834, 0.99238318566785833),
+            complex_t(-0.13251878245234017, 0.88526176928599476),
+            complex_t(-0.21417299146122798, 0.69453770674202242),
+            complex_t(-0.2774054135391581, 0.43964616384408195),
+            complex_t(-0.31720645792843832, 0.14543025128196443),
+            // order 11
+            complex_t(-0.038229294943282872, 0.9937618388264341),
+            complex_t(-0.11117119560254383, 0.90499137749078284),
+            complex_t(-0.1820061367546249, 0.74592911579198218),
+            complex_t(-0.2397116104861334, 0.53093980580918665),
+            complex_t(-0.27629975271160745, 0.2767427360671405),
+            complex_t(-0.28536255428818419, 0),
+            // order 12
+            complex_t(-0.032761159570974814, 0.99472299744166581),
+            complex_t(-0.095883268239474809, 0.91892060906261031),
+            complex_t(-0.15891973683435437, 0.7822122338010199),
+            complex_t(-0.21346844622619121, 0.59517038780302889),
+            complex_t(-0.2541921714697648, 0.3697783705829768),
+            complex_t(-0.28027747391215729, 0.12175493710869778),
+            // order 13
+            complex_t(-0.028071444001624105, 0.99552594062959077),
+            complex_t(-0.082523777449452412, 0.93078033560841267),
+            complex_t(-0.13787621212687173, 0.8135621379816016),
+            complex_t(-0.18728571268320013, 0.65209635860929338),
+            complex_t(-0.2257829000180219, 0.45564551041379786),
+            complex_t(-0.24944983091447992, 0.23498827067059419),
+            complex_t(-0.25488098972289175, 0),
+            // order 14
+            complex_t(-0.024558867531577926, 0.99611872417026115),
+            complex_t(-0.072487413798893993, 0.93960836712105289),
+            complex_t(-0.12202255856243031, 0.83689759903621785),
+            complex_t(-0.16767313354460317, 0.69438632239254605),
+            complex_t(-0.20560625245312514, 0.51904063071558604),
+            complex_t(-0.23345907477340563, 0.31894207643381461),
+            complex_t(-0.25176998450524501, 0.10479598033746899),
+            // order 15
+            complex_t(-0.021484270217860875, 0.99662854717524785),
+            complex_t(-0.063598460725282829, 0.94729774003364409),
+            complex_t(-0.1076256641742921, 0.85741067959187378),
+            complex_t(-0.14900530158852138, 0.73213621168705834),
+            complex_t(-0.18443458670069043, 0.57703176658632527),
+            complex_t(-0.21132036995447739, 0.39861171541519763),
+            complex_t(-0.2274843451909388, 0.20420284685668127),
+            complex_t(-0.23091120734845644, 0),
+            // order 16
+            complex_t(-0.019095063422348572, 0.99702081690923816),
+            complex_t(-0.056677034355219084, 0.95324775440090448),
+            complex_t(-0.096389189067553241, 0.8732834046817155),
+            complex_t(-0.1344427103587291, 0.76131648541082531),
+            complex_t(-0.1681526157861967, 0.62170507572830502),
+            complex_t(-0.19552997306439562, 0.45948753517914509),
+            complex_t(-0.21550080666789365, 0.28036151625607547),
+            complex_t(-0.22902785737609055, 0.092035462688461245),
+            // order 17
+            complex_t(-0.016970829465488859, 0.99736531371816906),
+            complex_t(-0.050474407723933787, 0.95851960398295322),
+            complex_t(-0.086155148079092095, 0.88743346903755815),
+            complex_t(-0.12079870578622591, 0.78759081968035527),
+            complex_t(-0.15210657575916467, 0.66255178378292745),
+            complex_t(-0.17824986083018171, 0.51646318119514423),
+            complex_t(-0.19774531991498825, 0.35407353543733699),
+            complex_t(-0.20925684395503749, 0.18056963147992031),
+            complex_t(-0.21149766977996295, 0),
+            // order 18
+            complex_t(-0.015272514144862671, 0.99763879656938526),
+            complex_t(-0.045508366414944018, 0.96272174163205027),
+            complex_t(-0.077946509741369269, 0.8987122308742358),
+            complex_t(-0.10984656017820521, 0.80852150386966992),
+            complex_t(-0.13928205021657622, 0.69503181399511449),
+            complex_t(-0.16475173636318888, 0.56155998096563953),
+            complex_t(-0.18515166324865526, 0.41186506483354685),
+            complex_t(-0.2000218061861011, 0.2501044908161808),
+            complex_t(-0.21041593856374324, 0.082077509691935363),
+            // order 19
+            complex_t(-0.013743784017502885, 0.99788277941168324),
+            complex_t(-0.041013241603981732, 0.96649474434732607),
+            complex_t(-0.070432940538539809, 0.90888282682712951),
+            complex_t(-0.099633649716040759, 0.82752595079306157),
+            complex_t(-0.12695258624462757, 0.72482723117405334),
+            complex_t(-0.15105792064994181, 0.6035559890465394),
+            complex_t(-0.17085548323592176, 0.46689309436153681),
+            complex_t(-0.18543511238372626, 0.31839473864077267),
+            complex_t(-0.19390913023678502, 0.16185523186917333),
+            complex_t(-0.19541000687994026, 0),
+            // order 20
+            complex_t(-0.012493580089441552, 0.99808127142452319),
+            complex_t(-0.037333281676166237, 0.96957349067335941),
+            complex_t(-0.064273282311689231, 0.91718191276494465),
+            complex_t(-0.091252577970560356, 0.84302793080832628),
+            complex_t(-0.11684665370771739, 0.74910625154487975),
+            complex_t(-0.13992736070747119, 0.6376902553958208),
+            complex_t(-0.15959566318227295, 0.51137125743569134),
+            complex_t(-0.17521326941153451, 0.37301640718847889),
+            complex_t(-0.18663132325256479, 0.22574788825159353),
+            complex_t(-0.1948710022685459, 0.074085125119099218),
+            // order 21
+            complex_t(-0.011356898828337772, 0.99826053648897684),
+            complex_t(-0.033973802637447391, 0.97236738602495543),
+            complex_t(-0.058604720609245486, 0.92473682508733912),
+            complex_t(-0.08343896983048589, 0.85720989189560459),
+            complex_t(-0.10723292638830714, 0.77147924746837448),
+            complex_t(-0.12899081379137314, 0.66946926621306724),
+            complex_t(-0.14788369203997492, 0.55338969777687474),
+            complex_t(-0.16321903386522021, 0.425725005771668),
+            complex_t(-0.17440510113632648, 0.28920039573488232),
+            complex_t(-0.18081214934172404, 0.14666759671354704),
+            complex_t(-0.18183195115439652, 0),
+            // order 22
+            complex_t(-0.01040999182695412, 0.99840928271491347),
+            complex_t(-0.031173018250596835, 0.97469092483842124),
+            complex_t(-0.053873700631799928, 0.93101982554445784),
+            complex_t(-0.076911348133397603, 0.86900158926071092),
+            complex_t(-0.099202060517714019, 0.79006976392318284),
+            complex_t(-0.11988532433502361, 0.69583677250111375),
+            complex_t(-0.13825371531158909, 0.58814352184480034),
+            complex_t(-0.15374364856673442, 0.46904506948746383),
+            complex_t(-0.16597798144340442, 0.34077018297093675),
+            complex_t(-0.17497184627414275, 0.2057220210113028),
+            complex_t(-0.18167054027762627, 0.067525479980681424),
+            // order 23
+            complex_t(-0.0095419183585516969, 0.99854494739600586),
+            complex_t(-0.028597496002387736, 0.97681792676602541),
+            complex_t(-0.049497067693380831, 0.93678497692925733),
+            complex_t(-0.070815280717275497, 0.87986138582555407),
+            complex_t(-0.091594991994722083, 0.80728221917570231),
+            complex_t(-0.11107371641245718, 0.72042986489418859),
+            complex_t(-0.12861180614393514, 0.62088808311709021),
+            complex_t(-0.14366721567880908, 0.51044257987091757),
+            complex_t(-0.15578141958536718, 0.39106449630088441),
+            complex_t(-0.16455023535620267, 0.26488439390021484),
+            complex_t(-0.16950220622265505, 0.13409450522308675),
+            complex_t(-0.1701988186669901, 0),
+            // order 24
+            complex_t(-0.008807590225229962, 0.9986593583474116),
+            complex_t(-0.026417477504295017, 0.97861488162345467),
+            complex_t(-0.04578932888908066, 0.94165553104418109),
+            complex_t(-0.065646478293419894, 0.88903463898517254),
+            complex_t(-0.085142894849861178, 0.82181571634610762),
+            complex_t(-0.10360974196517198, 0.74117649075908054),
+            complex_t(-0.12048980613020002, 0.64845967611278488),
+            complex_t(-0.13531920607613365, 0.54517237321517853),
+            complex_t(-0.14773278245613305, 0.43296524642379935),
+            complex_t(-0.15750707772783798, 0.3136003178076443),
+            complex_t(-0.16474522646203502, 0.18896706574456509),
+            complex_t(-0.17030554155250233, 0.062042993336768389),
+            // order 25
+            complex_t(-0.0081297037224952063, 0.9987645518485887),
+            complex_t(-0.024400222207823122, 0.98027182996254902),
+            complex_t(-0.042342637562343632, 0.94615479892045584),
+            complex_t(-0.06080718489836754, 0.89753257985045698),
+            complex_t(-0.079038843355115226, 0.83533352088583956),
+            complex_t(-0.096441022416556194, 0.76057902755299189),
+            complex_t(-0.11251176302742417, 0.67443482181122605),
+            complex_t(-0.12682087821578023, 0.57821705679952573),
+            complex_t(-0.13900006914915233, 0.47338397326776033),
+            complex_t(-0.14873403228479062, 0.36152187212595843),
+            complex_t(-0.15573453691242281, 0.24432578965632218),
+            complex_t(-0.15963280236410943, 0.12351340231976286),
+            complex_t(-0.16010648880025966, 0),
+        };
+
+        // Poles of the order, or 0 if it is not in the table
+        static const complex_t* tablePoles(int numPoles)
+        {
+            if (numPoles < 1 || numPoles > tableOrders)
+                return 0;
+
+            // orders before numPoles take numPoles * numPoles / 4 entries
+            return poleTable + numPoles * numPoles / 4;
+        }
+
+        //------------------------------------------------------------------------------
+
         AnalogLowPass::AnalogLowPass()
             : m_numPoles(-1)
         {
@@ -209,37 +428,43 @@ namespace Dsp {
 
                 reset();
 
-                PolynomialFinderBase& poly(w->poly);
-                RootFinderBase& poles(w->roots);
+                const complex_t* roots = tablePoles(numPoles);
+                if (!roots)
+                {
+                    PolynomialFinderBase& poly(w->poly);
+                    RootFinderBase& poles(w->roots);
+
+                    poly.solve(numPoles);
+                    int degree = numPoles * 2;
+
+                    poles.coef()[0] = 1 + poly.coef()[0];
+                    poles.coef()[1] = 0;
+                    for (int i = 1; i <= degree; ++i)
+                    {
+                        poles.coef()[2 * i] = poly.coef()[i] * ((i & 1) ? -1 : 1);
+                        poles.coef()[2 * i + 1] = 0;
+                    }
+                    poles.solve(degree);
 
-                poly.solve(numPoles);
-                int degree = numPoles * 2;
+                    int j = 0;
+                    for (int i = 0; i < degree; ++i)
+                        if (poles.root()[i].real() <= 0)
+                            poles.root()[j++] = poles.root()[i];
+                    // sort descending imag() and cut degree in half
+                    poles.sort(degree / 2);
 
-                poles.coef()[0] = 1 + poly.coef()[0];
-                poles.coef()[1] = 0;
-                for (int i = 1; i <= degree; ++i)
-                {
-                    poles.coef()[2 * i] = poly.coef()[i] * ((i & 1) ? -1 : 1);
-                    poles.coef()[2 * i + 1] = 0;
+                    roots = poles.root();
                 }
-                poles.solve(degree);
-
-                int j = 0;
-                for (int i = 0; i < degree; ++i)
-                    if (poles.root()[i].real() <= 0)
-                        poles.root()[j++] = poles.root()[i];
-                // sort descending imag() and cut degree in half
-                poles.sort(degree / 2);
 
                 const int pairs = numPoles / 2;
                 for (int i = 0; i < pairs; ++i)
                 {
-                    complex_t c = poles.root()[i];
+                    complex_t c = roots[i];
                     addPoleZeroConjugatePairs(c, infinity());
                 }
 
                 if (numPoles & 1)
-                    add(poles.root()[pairs].real(), infinity());
+                    add(roots[pairs].real(), infinity());
             }
         }
 
@@ -250,6 +475,11 @@ namespace Dsp {
             double cutoffFrequency,
             WorkspaceBase* w)
         {
+            const DesignCache::Key key(DesignCache::familyLegendre, kindLowPass, order,
+                cutoffFrequency / sampleRate);
+            if (DesignCache::load(key, *this))
+                return;
+
             m_analogProto.design(order, w);
 
             LowPassTransform(cutoffFrequency / sampleRate,
@@ -257,6 +487,8 @@ namespace Dsp {
                 m_analogProto);
 
             Cascade::setLayout(m_digitalProto);
+
+            DesignCache::store(key, *this);
         }
 
         void HighPassBase::setup(int order,
@@ -264,6 +496,11 @@ namespace Dsp {
             double cutoffFrequency,
             WorkspaceBase* w)
         {
+            const DesignCache::Key key(DesignCache::familyLegendre, kindHighPass, order,
+                cutoffFrequency / sampleRate);
+            if (DesignCache::load(key, *this))
+                return;
+
             m_analogProto.design(order, w);
 
             HighPassTransform(cutoffFrequency / sampleRate,
@@ -271,6 +508,8 @@ namespace Dsp {
                 m_analogProto);
 
             Cascade::setLayout(m_digitalProto);
+
+            DesignCache::store(key, *this);
         }
 
         void BandPassBase::setup(int order,
@@ -279,6 +518,11 @@ namespace Dsp {
             double widthFrequency,
             WorkspaceBase* w)
         {
+            const DesignCache::Key key(DesignCache::familyLegendre, kindBandPass, order,
+                centerFrequency / sampleRate, widthFrequency / sampleRate);
+            if (DesignCache::load(key, *this))
+                return;
+
             m_analogProto.design(order, w);
 
             BandPassTransform(centerFrequency / sampleRate,
@@ -287,6 +531,8 @@ namespace Dsp {
                 m_analogProto);
 
             Cascade::setLayout(m_digitalProto);
+
+            DesignCache::store(key, *this);
         }
 
         void BandStopBase::setup(int order,
@@ -295,6 +541,11 @@ namespace Dsp {
             double widthFrequency,
             WorkspaceBase* w)
         {
+            const DesignCache::Key key(DesignCache::familyLegendre, kindBandStop, order,
+                centerFrequency / sampleRate, widthFrequency / sampleRate);
+            if (DesignCache::load(key, *this))
+                return;
+
             m_analogProto.design(order, w);
 
             BandStopTransform(centerFrequency / sampleRate,
@@ -303,6 +554,8 @@ namespace Dsp {
                 m_analogProto);
 
             Cascade::setLayout(m_digitalProto);
+
+            DesignCache::store(key, *this);
         }
 
     }
@@ -3,6 +3,13 @@
 
 #include "Common.h"
 
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE__)
+#  include <xmmintrin.h>
+#  define DSPFILTERS_MXCSR 1
+#elif defined(__aarch64__) && (defined(__GNUC__) || defined(__clang__))
+#  define DSPFILTERS_FPCR 1
+#endif
+
 namespace Dsp {
 
     const double doublePi = 3.1415926535897932384626433832795028841971;
@@ -79,11 +86,35 @@ namespace Dsp {
         return Dsp::is_nan(v.real()) || Dsp::is_nan(v.imag());
     }
 
+    // Clamps v to the range of the integer type Value
+    template <typename Value>
+    inline Value saturate(int64_t v)
+    {
+        const int64_t lo = std::numeric_limits<Value>::min();
+        const int64_t hi = std::numeric_limits<Value>::max();
+        return static_cast<Value>(std::min(std::max(v, lo), hi));
+    }
+
+    // Rounds v to a fixed point Value with fracBits fractional bits,
+    // saturating at the ends of the range
+    template <typename Value>
+    inline Value toFixed(double v, int fracBits)
+    {
+        const double q = std::floor(std::ldexp(v, fracBits) + 0.5);
+        const double lo = std::numeric_limits<Value>::min();
+        const double hi = std::numeric_limits<Value>::max();
+        return static_cast<Value>(std::min(std::max(q, lo), hi));
+    }
+
     //------------------------------------------------------------------------------
 
     /*
      * Hack to prevent denormals
      *
+     * This is the default denormal policy of the processing state. It adds a
+     * tiny alternating offset to the input of the first section, see
+     * DenormalFlush for the alternative.
+     *
      */
 
      //const double anti_denormal_vsa = 1e-16; // doesn't prevent denormals
@@ -110,10 +141,103 @@ namespace Dsp {
             return anti_denormal_vsa;
         }
 
+        // Block kernels generate the alternating current themselves,
+        // these keep it in step with ac() across calls.
+        inline double getAc() const
+        {
+            return m_v;
+        }
+
+        inline void setAc(double v)
+        {
+            m_v = v;
+        }
+
+        // Nothing to set up around a block, see DenormalFlush
+        struct Scope
+        {
+            Scope() { }
+            ~Scope() { }
+        };
+
     private:
         double m_v;
     };
 
+    //------------------------------------------------------------------------------
+
+    /*
+     * Sets the flush-to-zero and denormals-are-zero modes of the processor
+     * for its lifetime and puts the previous modes back afterwards. On x86
+     * these are bits of MXCSR, on 64 bit ARM the FZ bit of FPCR (which does
+     * both). Elsewhere it does nothing.
+     *
+     */
+    class ScopedFlushDenormals
+    {
+    public:
+        ScopedFlushDenormals()
+        {
+#if defined(DSPFILTERS_MXCSR)
+            m_saved = _mm_getcsr();
+            _mm_setcsr(m_saved | 0x8040); // FTZ | DAZ
+#elif defined(DSPFILTERS_FPCR)
+            unsigned long long fpcr;
+            __asm__ __volatile__("mrs %0, fpcr" : "=r"(fpcr));
+            m_saved = fpcr;
+            fpcr |= 1ull << 24; // FZ
+            __asm__ __volatile__("msr fpcr, %0" : : "r"(fpcr));
+#endif
+        }
+
+        ~ScopedFlushDenormals()
+        {
+#if defined(DSPFILTERS_MXCSR)
+            _mm_setcsr(m_saved);
+#elif defined(DSPFILTERS_FPCR)
+            __asm__ __volatile__("msr fpcr, %0" : : "r"(m_saved));
+#endif
+        }
+
+    private:
+        ScopedFlushDenormals(const ScopedFlushDenormals&);
+        ScopedFlushDenormals& operator= (const ScopedFlushDenormals&);
+
+#if defined(DSPFILTERS_MXCSR)
+        unsigned int m_saved;
+#elif defined(DSPFILTERS_FPCR)
+        unsigned long long m_saved;
+#endif
+    };
+
+    /*
+     * Denormal policy that adds nothing to the signal. Instead the block
+     * processing functions run under ScopedFlushDenormals, so silence into a
+     * filter at rest stays exactly zero and the output can be compared bit
+     * for bit. A decaying tail may end in a tiny cycle just above the
+     * smallest normal number rather than at zero, but never in denormals.
+     *
+     * Samples processed one at a time are not covered by the scope; callers
+     * that do so can put a ScopedFlushDenormals around their own loop.
+     *
+     */
+    class DenormalFlush : public DenormalPrevention
+    {
+    public:
+        DenormalFlush()
+        {
+            setAc(0);
+        }
+
+        // the block kernels keep this at zero
+        static inline double ac()
+        {
+            return 0;
+        }
+
+        typedef ScopedFlushDenormals Scope;
+    };
+
 }
 
 #endif
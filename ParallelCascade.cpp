@@ -0,0 +1,112 @@
+#include "pch.h"
+#include "Common.h"
+#include "ParallelCascade.h"
+
+namespace Dsp {
+
+    ParallelCascade::ParallelCascade()
+        : m_numStages(0)
+        , m_maxStages(0)
+        , m_stageArray(0)
+        , m_direct(1)
+    {
+    }
+
+    void ParallelCascade::setCascadeStorage(const Storage& storage)
+    {
+        m_numStages = 0;
+        m_maxStages = storage.maxStages;
+        m_stageArray = storage.stageArray;
+    }
+
+    complex_t ParallelCascade::response(double normalizedFrequency) const
+    {
+        complex_t ch(m_direct);
+
+        const Biquad* stage = m_stageArray;
+        for (int i = m_numStages; --i >= 0; ++stage)
+            ch += stage->response(normalizedFrequency);
+
+        return ch;
+    }
+
+    void ParallelCascade::setLayout(const std::vector<PoleZeroPair>& pairs,
+        const Cascade& cascade)
+    {
+        const int numStages = static_cast<int>(pairs.size());
+        assert(numStages == cascade.getNumStages());
+        assert(numStages <= m_maxStages);
+
+        // Every section of the cascade is b0 z^2 + b1 z + b2 over the monic
+        // z^2 + a1 z + a2 (or first order), so
+        //
+        //  H(z) = direct + sum of r_i / (z - p_i)
+        //
+        // where direct is the product of the b0 and r_i is the residue
+        // of H at the pole p_i.
+
+        std::vector<complex_t> poles;
+        poles.reserve(2 * numStages);
+        for (int k = 0; k < numStages; ++k)
+        {
+            poles.push_back(pairs[k].poles.first);
+            if (!pairs[k].isSinglePole())
+                poles.push_back(pairs[k].poles.second);
+        }
+
+        const int numPoles = static_cast<int>(poles.size());
+        std::vector<complex_t> residues(numPoles);
+        for (int i = 0; i < numPoles; ++i)
+        {
+            const complex_t p = poles[i];
+
+            complex_t num(1);
+            for (int k = 0; k < numStages; ++k)
+            {
+                const Biquad& s = cascade[k];
+                if (pairs[k].isSinglePole())
+                    num *= s.m_b0 * p + s.m_b1;
+                else
+                    num *= (s.m_b0 * p + s.m_b1) * p + s.m_b2;
+            }
+
+            complex_t den(1);
+            for (int j = 0; j < numPoles; ++j)
+                if (j != i)
+                    den *= p - poles[j];
+
+            assert(den != complex_t(0)); // repeated pole
+            residues[i] = num / den;
+        }
+
+        m_direct = 1;
+        for (int k = 0; k < numStages; ++k)
+            m_direct *= cascade[k].m_b0;
+
+        const complex_t* r = &residues[0];
+        const complex_t* p = &poles[0];
+        Cascade::Stage* stage = m_stageArray;
+        for (int k = 0; k < numStages; ++k, ++stage)
+        {
+            if (pairs[k].isSinglePole())
+            {
+                stage->setCoefficients(1, -p[0].real(), 0,
+                    0, r[0].real(), 0);
+                ++r;
+                ++p;
+            }
+            else
+            {
+                // r0/(z-p0) + r1/(z-p1) over a common denominator
+                stage->setCoefficients(1,
+                    -(p[0] + p[1]).real(), (p[0] * p[1]).real(),
+                    0, (r[0] + r[1]).real(), -(r[0] * p[1] + r[1] * p[0]).real());
+                r += 2;
+                p += 2;
+            }
+        }
+
+        m_numStages = numStages;
+    }
+
+}
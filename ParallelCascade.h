@@ -0,0 +1,409 @@
+#ifndef DSPFILTERS_PARALLELCASCADE_H
+#define DSPFILTERS_PARALLELCASCADE_H
+
+#include "Common.h"
+#include "Biquad.h"
+#include "Cascade.h"
+#include "MathSupplement.h"
+#include "Types.h"
+
+namespace Dsp {
+
+    // Process a block of samples through a sum of sections, section k in
+    // lane k % Vec::lanes of vector group k / Vec::lanes. Lanes past the
+    // last section have zero coefficients and contribute nothing.
+    template <class Vec, class StateType, class Stage, typename Sample>
+    void processParallel(int numSamples,
+        Sample* dest,
+        double direct,
+        int numStages,
+        const Stage* stageArray,
+        StateType* stateArray,
+        DenormalPrevention& denormal)
+    {
+        typedef typename Vec::value_type value_type;
+
+        enum
+        {
+            lanes = Vec::lanes,
+            chunkSamples = 64,
+            maxGroups = 8
+        };
+
+        Biquad zeroStage;
+        zeroStage.setCoefficients(1, 0, 0, 0, 0, 0);
+        StateType zeroState[lanes];
+
+        LaneBiquad<Vec> section[maxGroups];
+        LaneState<StateType, Vec> state[maxGroups];
+
+        // the alternating denormal offset only goes into the first section
+        value_type t[lanes];
+        value_type f[lanes];
+        for (int i = 0; i < lanes; ++i)
+        {
+            t[i] = 0;
+            f[i] = 1;
+        }
+        t[0] = static_cast<value_type>(denormal.getAc());
+        f[0] = -1;
+        Vec vsa = Vec::load(t);
+        const Vec flip = Vec::load(f);
+        const Vec zero = Vec::broadcast(0);
+
+        const int numGroups = (numStages + lanes - 1) / lanes;
+
+        double in[chunkSamples];
+        double out[chunkSamples];
+
+        for (int offset = 0; offset < numSamples; offset += chunkSamples)
+        {
+            const int count = std::min(int(chunkSamples), numSamples - offset);
+
+            for (int n = 0; n < count; ++n)
+            {
+                in[n] = dest[offset + n];
+                out[n] = direct * in[n];
+            }
+
+            // Very large filters are run in batches of maxGroups
+            for (int first = 0; first < numGroups; first += maxGroups)
+            {
+                const int groups = std::min(int(maxGroups), numGroups - first);
+
+                for (int g = 0; g < groups; ++g)
+                {
+                    const Biquad* stages[lanes];
+                    StateType* states[lanes];
+                    for (int i = 0; i < lanes; ++i)
+                    {
+                        const int k = (first + g) * lanes + i;
+                        if (k < numStages)
+                        {
+                            stages[i] = &stageArray[k];
+                            states[i] = &stateArray[k];
+                        }
+                        else
+                        {
+                            stages[i] = &zeroStage;
+                            states[i] = &zeroState[i];
+                        }
+                    }
+                    section[g].setLanes(stages);
+                    state[g].load(states, 0);
+                }
+
+                for (int n = 0; n < count; ++n)
+                {
+                    const Vec x = Vec::broadcast(static_cast<value_type>(in[n]));
+                    int g = 0;
+                    Vec sum = zero;
+                    if (first == 0)
+                    {
+                        vsa = vsa * flip;
+                        sum = state[0].process1(x, section[0], vsa);
+                        ++g;
+                    }
+                    for (; g < groups; ++g)
+                        sum = sum + state[g].process1(x, section[g], zero);
+
+                    sum.store(t);
+                    double y = out[n];
+                    for (int i = 0; i < lanes; ++i)
+                        y += t[i];
+                    out[n] = y;
+                }
+
+                for (int g = 0; g < groups; ++g)
+                {
+                    StateType* states[lanes];
+                    for (int i = 0; i < lanes; ++i)
+                    {
+                        const int k = (first + g) * lanes + i;
+                        states[i] = k < numStages ? &stateArray[k] : &zeroState[i];
+                    }
+                    state[g].store(states, 0);
+                }
+            }
+
+            for (int n = 0; n < count; ++n)
+                dest[offset + n] = static_cast<Sample> (out[n]);
+        }
+
+        vsa.store(t);
+        denormal.setAc(t[0]);
+    }
+
+    //------------------------------------------------------------------------------
+
+    /*
+     * Holds a filter in parallel form: a direct gain plus a sum of second
+     * order sections which all read the same input.
+     *
+     * A cascade is expanded by partial fractions. Every pole of the cascade
+     * gets its residue, and each pole pair of the layout becomes one section
+     * with b0 = 0. Since no section waits on the output of another, the
+     * sections run side by side in SIMD lanes and the serial dependency of
+     * the filter is that of a single section instead of the whole chain.
+     *
+     * The expansion needs distinct poles, which is the case for all of the
+     * pole filter families in this library. The output matches the cascade
+     * to within rounding.
+     *
+     */
+
+     // Factored interface, see ParallelCascadeStages for storage
+    class ParallelCascade
+    {
+    public:
+        template <class StateType, class Denormal = DenormalPrevention>
+        class StateBase : private Denormal
+        {
+        public:
+            typedef StateType state_type_t;
+            typedef Denormal denormal_t;
+
+            template <typename Sample>
+            inline Sample process(const Sample in, const ParallelCascade& c)
+            {
+                const double vsa = this->ac();
+                double out = c.m_direct * in;
+                StateType* state = m_stateArray;
+                Biquad const* stage = c.m_stageArray;
+                for (int i = 0; i < c.m_numStages; ++i)
+                    out += (state++)->process1(double(in), *stage++,
+                        i == 0 ? vsa : 0);
+                return static_cast<Sample> (out);
+            }
+
+            // Process a block of samples, running the sections in SIMD lanes
+            template <typename Sample>
+            void process(int numSamples, Sample* dest, const ParallelCascade& c)
+            {
+                typename Denormal::Scope scope;
+                processParallel<typename LaneVectors<StateType>::native_t>(
+                    numSamples, dest, c.m_direct,
+                    c.m_numStages, c.m_stageArray, m_stateArray, *this);
+            }
+
+            // Process a block of samples out of place
+            template <typename Source, typename Sample>
+            void process(int numSamples,
+                const Source* src,
+                Sample* dest,
+                const ParallelCascade& c)
+            {
+                for (int n = 0; n < numSamples; ++n)
+                    dest[n] = static_cast<Sample>(src[n]);
+                process(numSamples, dest, c);
+            }
+
+            // Process several channels, each through its own sections in
+            // SIMD lanes. The channels run one after another.
+            template <class ChannelState, typename Sample>
+            static void process(int numSamples,
+                int numChannels,
+                Sample* const* arrayOfChannels,
+                ChannelState* stateArray,
+                const ParallelCascade& c)
+            {
+                for (int i = 0; i < numChannels; ++i)
+                    stateArray[i].process(numSamples, arrayOfChannels[i], c);
+            }
+
+            // Process several channels out of place
+            template <class ChannelState, typename Source, typename Sample>
+            static void process(int numSamples,
+                int numChannels,
+                const Source* const* sourceChannels,
+                Sample* const* arrayOfChannels,
+                ChannelState* stateArray,
+                const ParallelCascade& c)
+            {
+                for (int i = 0; i < numChannels; ++i)
+                    stateArray[i].process(numSamples, sourceChannels[i],
+                        arrayOfChannels[i], c);
+            }
+
+            // Process interleaved frames, a chunk of each channel at a time
+            template <class ChannelState, typename Sample>
+            static void process(int numSamples,
+                int numChannels,
+                Sample* frames,
+                int frameStride,
+                ChannelState* stateArray,
+                const ParallelCascade& c)
+            {
+                enum { chunkSamples = 64 };
+
+                Sample chunk[chunkSamples];
+                for (int i = 0; i < numChannels; ++i)
+                {
+                    for (int offset = 0; offset < numSamples; offset += chunkSamples)
+                    {
+                        const int count = std::min(int(chunkSamples),
+                            numSamples - offset);
+                        Sample* frame = frames + offset * frameStride + i;
+                        for (int n = 0; n < count; ++n)
+                            chunk[n] = frame[n * frameStride];
+                        stateArray[i].process(count, chunk, c);
+                        for (int n = 0; n < count; ++n)
+                            frame[n * frameStride] = chunk[n];
+                    }
+                }
+            }
+
+            // Number of samples by which the output lags the input
+            static int getLatency(const ParallelCascade&)
+            {
+                return 0;
+            }
+
+        protected:
+            StateBase(StateType* stateArray)
+                : m_stateArray(stateArray)
+            {
+            }
+
+        protected:
+            StateType* m_stateArray;
+        };
+
+    public:
+        int getNumStages() const
+        {
+            return m_numStages;
+        }
+
+        const Cascade::Stage& operator[] (int index) const
+        {
+            assert(index >= 0 && index < m_numStages);
+            return m_stageArray[index];
+        }
+
+        double getDirectGain() const
+        {
+            return m_direct;
+        }
+
+        // Calculate filter response at the given normalized frequency.
+        complex_t response(double normalizedFrequency) const;
+
+        // Expand a designed filter into parallel form. Pole filters supply
+        // the exact poles of their digital prototype through getPoleZeros().
+        template <class FilterClass>
+        void setup(const FilterClass& filter)
+        {
+            setLayout(filter.getPoleZeros(), filter);
+        }
+
+        // Process a block of samples in the given form
+        template <class StateType, typename Sample>
+        void process(int numSamples, Sample* dest, StateType& state) const
+        {
+            state.process(numSamples, dest, *this);
+        }
+
+        // Process a block of samples for several channels, see
+        // Cascade::process
+        template <class ChannelState, typename Sample>
+        void process(int numSamples,
+            int numChannels,
+            Sample* const* arrayOfChannels,
+            ChannelState* stateArray) const
+        {
+            ChannelState::process(numSamples, numChannels,
+                arrayOfChannels, stateArray, *this);
+        }
+
+        // Process several channels out of place
+        template <class ChannelState, typename Source, typename Sample>
+        void process(int numSamples,
+            int numChannels,
+            const Source* const* sourceChannels,
+            Sample* const* arrayOfChannels,
+            ChannelState* stateArray) const
+        {
+            ChannelState::process(numSamples, numChannels,
+                sourceChannels, arrayOfChannels, stateArray, *this);
+        }
+
+        // Process interleaved frames in place
+        template <class ChannelState, typename Sample>
+        void process(int numSamples,
+            int numChannels,
+            Sample* frames,
+            int frameStride,
+            ChannelState* stateArray) const
+        {
+            ChannelState::process(numSamples, numChannels,
+                frames, frameStride, stateArray, *this);
+        }
+
+    protected:
+        ParallelCascade();
+
+        struct Storage
+        {
+            Storage(int maxStages_, Cascade::Stage* stageArray_)
+                : maxStages(maxStages_)
+                , stageArray(stageArray_)
+            {
+            }
+
+            int maxStages;
+            Cascade::Stage* stageArray;
+        };
+
+        void setCascadeStorage(const Storage& storage);
+
+        void setLayout(const std::vector<PoleZeroPair>& pairs,
+            const Cascade& cascade);
+
+    private:
+        int m_numStages;
+        int m_maxStages;
+        Cascade::Stage* m_stageArray;
+        double m_direct;
+    };
+
+    //------------------------------------------------------------------------------
+
+    // Storage for ParallelCascade
+    template <int MaxStages>
+    class ParallelCascadeStages : public ParallelCascade
+    {
+    public:
+        template <class StateType, class Denormal = DenormalPrevention>
+        class State : public ParallelCascade::StateBase <StateType, Denormal>
+        {
+        public:
+            State() : ParallelCascade::StateBase <StateType, Denormal>(m_states)
+            {
+                ParallelCascade::StateBase <StateType, Denormal>::m_stateArray = m_states;
+                reset();
+            }
+
+            void reset()
+            {
+                StateType* state = m_states;
+                for (int i = MaxStages; --i >= 0; ++state)
+                    state->reset();
+            }
+
+        private:
+            StateType m_states[MaxStages];
+        };
+
+        ParallelCascadeStages()
+        {
+            setCascadeStorage(Storage(MaxStages, m_stages));
+        }
+
+    private:
+        Cascade::Stage m_stages[MaxStages];
+    };
+
+}
+
+#endif
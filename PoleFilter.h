@@ -4,6 +4,7 @@
 #include "Common.h"
 #include "MathSupplement.h"
 #include "Cascade.h"
+#include "DesignCache.h"
 
 namespace Dsp {
 
@@ -42,9 +43,26 @@ namespace Dsp {
                 vpz.push_back(m_digitalProto[i]);
             return vpz;
         }
+
+        int getPoleZeros(PoleZeroPair* pairs, int maxPairs) const
+        {
+            const int numPairs = (m_digitalProto.getNumPoles() + 1) / 2;
+            const int count = std::min(numPairs, maxPairs);
+            for (int i = 0; i < count; ++i)
+                pairs[i] = m_digitalProto[i];
+            return numPairs;
+        }
 #endif
 
+        // The digital poles and zeros in place, valid until the next setup()
+        const LayoutBase& getDigitalLayout() const
+        {
+            return m_digitalProto;
+        }
+
     protected:
+        friend class DesignCache;
+
         LayoutBase m_digitalProto;
     };
 
@@ -56,6 +56,21 @@ class Filter
   frequency in the range (0..nyquist = 0.5]. From the complex number the
   magnitude and phase can be calculated.
 
+  getPoleZeros (pairs, maxPairs) fills a caller supplied array instead of
+  returning a vector, and returns the number of pairs, so it can be used on
+  the audio thread without allocating memory. A class of your own derived
+  from Filter only has to provide the vector version; the default array
+  version copies from it, and so does allocate.
+
+  Filter::responseGrid ()
+  Filter::magnitudeDbGrid ()
+
+  For plotting, these evaluate the response or its magnitude in decibels at
+  many frequencies in one call: an array of normalized frequencies, or a
+  linear or logarithmic grid from a first to a last frequency. Several
+  frequencies are computed at once in SIMD lanes, and grid points are
+  stepped by complex rotation instead of calling cos and sin for each.
+
   Filter::getNumChannels()
   Filter::reset()
   Filter::process()
@@ -70,7 +85,8 @@ class Filter
 
 
 
-template <class DesignClass, int Channels = 0, class StateType = DirectFormII>
+template <class DesignClass, int Channels = 0, class StateType = DirectFormII,
+          class Denormal = DenormalPrevention>
 class FilterDesign : public Filter
 
   This subclass of Filter takes a DesignClass (explained below) representing
@@ -96,9 +112,21 @@ class SmoothedFilterDesign : public Filter
   caller, except that the constructor takes an additional parameter that
   indicates the duration of transitions when parameters change.
 
+  By default the filter is redesigned at every sample of a transition. An
+  optional control interval, the second constructor parameter or
+  setControlInterval(), redesigns only every so many samples and ramps the
+  coefficients linearly in between, which costs far less. Long intervals
+  on fast sweeps of high order filters follow the per sample transition
+  less closely, 16 to 32 samples is a good start.
 
+  The coefficients of a transition are worked out once per sample for all
+  channels, and the channels then run through them together in SIMD lanes,
+  so extra channels add about what they add outside a transition.
 
-template <class FilterClass, int Channels = 0, class StateType = DirectFormII>
+
+
+template <class FilterClass, int Channels = 0, class StateType = DirectFormII,
+          class Denormal = DenormalPrevention>
 class SimpleFilter : public FilterClass
 
   This is a simple wrapper around a given raw FilterClass (explained below).
@@ -118,6 +146,141 @@ class SimpleFilter : public FilterClass
   or after changing parameters, to clear the state and prevent audible
   artifacts.
 
+  The Denormal parameter chooses how denormal numbers are kept out of the
+  filter state. DenormalPrevention, the default, adds a tiny alternating
+  offset to the input. DenormalFlush adds nothing and instead switches the
+  processor to flush-to-zero and denormals-are-zero mode for the duration of
+  each process() call, so a filter at rest keeps silence exactly zero and
+  results can be compared bit for bit. The previous mode is always restored.
+  The tail of a sound still need not reach exact zero: flushing can leave it
+  circling just above the smallest normal number (about 1e-307 in double),
+  which costs nothing, where without either policy it would stay denormal
+  and run many times slower.
+
+  Passing dynamicChannels as Channels to either container chooses the number
+  of channels at run time with setNumChannels(). The states of all channels
+  are kept in one aligned block, and changing the count resets them. One
+  instantiation then serves every channel layout.
+
+  When these containers process more than one channel, the channels are
+  run in groups through SIMD lanes (2, 4 or 8 channels per group for SSE2,
+  AVX and AVX-512 builds). The DirectFormI, DirectFormII and
+  TransposedDirectFormII forms have vectorized kernels; the output is
+  identical to processing each channel on its own. That holds as long as the
+  compiler does not fuse multiplies and adds in the scalar code, which it
+  does not by default or under /fp:precise. GCC fuses them when the target
+  has FMA, for example with -march=native or -mfma, and then the one-channel
+  path can differ in the last bits; add -ffp-contract=off to such builds to
+  keep the outputs identical.
+
+  Interleaved buffers can be processed in place without splitting them into
+  channels first: process(numSamples, frames, frameStride) reads sample n of
+  channel i from frames[n * frameStride + i]. frameStride is normally the
+  number of channels, or larger to leave trailing channels of each frame
+  untouched. The output is identical to processing the channels separately.
+
+  To keep the input, for example for a dry/wet mix, pass separate source and
+  destination channels: process(numSamples, sourceChannels, arrayOfChannels).
+  Cascade, Biquad and SimpleFilter accept any source sample type, such as
+  short or float samples filtered into double, and convert as they read. The
+  output is the same as copying the source over and processing in place.
+
+  The library also carries these kernels built for SSE2, AVX and AVX-512 in
+  DispatchSse2.cpp, DispatchAvx.cpp and DispatchAvx512.cpp, and picks the
+  widest set the processor supports at run time. A baseline build therefore
+  still uses AVX-512 where it is available. All files are compiled with the
+  same switches; do not add -mavx, -mavx512f or /arch:AVX to the kernel
+  files, since only their kernels may use those instructions. With GCC and
+  Clang the AVX kernels need optimization (-O1 or higher), and unoptimized
+  builds fall back to SSE2.
+
+  Every form also comes in a single precision version, DirectFormIFloat,
+  DirectFormIIFloat, TransposedDirectFormIFloat and TransposedDirectFormIIFloat,
+  which keeps its state and does its arithmetic in float. These run twice as
+  many channels per SIMD group, which suits low order filters and RBJ
+  sections that do not need double precision.
+
+  For integer PCM there are the fixed point forms DirectFormIQ15 and
+  DirectFormIQ31. They filter int16_t or int32_t samples directly, with the
+  coefficients in Q2.14 or Q2.30, a 64 bit accumulator, and the rounding
+  error fed back into the next sample. Outputs saturate. For these forms a
+  Cascade spreads the gain of the design over its sections instead of
+  keeping it in the first one, where it would round away. Q15 is enough for
+  cutoffs above about 2% of the sample rate; below that its coefficients
+  place the poles too coarsely (an RBJ low pass at 200 Hz and 48 kHz is off
+  by 9% of full scale) and Q31 is needed. Leave a few dB of headroom for
+  high passes: their sections cannot pass their gain on, and full scale
+  input can overshoot. The design's getLostCoefficients() counts
+  coefficients that round to zero. These forms have no SIMD lanes yet:
+  channels are filtered one at a time, so what they save over converting
+  to floating point is the two conversion passes.
+
+  For a single channel through a long cascade, use SkewedDirectFormII as the
+  StateType. It places consecutive stages in consecutive SIMD lanes with a
+  one sample skew, which delays the output by getLatency() samples of the
+  SimpleFilter or FilterDesign (one per stage after the first) but is
+  otherwise identical to DirectFormII.
+
+  When a filter is always set up with the same order, FixedStages<Stages, Form>
+  as the StateType runs exactly Stages sections of the given Form with the
+  stage loop unrolled at compile time, for example
+  SimpleFilter<Butterworth::LowPass<4>, 2, FixedStages<2> >. Stages is
+  (order + 1) / 2 for low and high pass, the order for band pass and band
+  stop. The output is identical to processing in Form.
+
+  For a single channel through one or two sections, BlockStateSpace<K> computes
+  K output samples at a time from a precomputed state-space form, so the
+  outputs of a block no longer wait on each other. There is no added latency
+  and the output matches TransposedDirectFormII to within rounding.
+
+  ParallelCascadeStages<MaxStages> holds a designed filter expanded by partial
+  fractions into a direct gain plus second order sections that all read the
+  same input. Call setup() with the designed filter and process() it just like
+  the Cascade. The sections run side by side in SIMD lanes, which helps high
+  order Chebyshev and Elliptic designs. Its State takes the same Denormal
+  policy as the cascade states, and as the FilterClass of a SimpleFilter it
+  processes several channels, interleaved frames or out of place, one
+  channel after another.
+
+  StreamPool<StateType> holds thousands of independent streams, each with
+  a small filter of its own and up to the pool's number of stages. add()
+  copies a designed filter or RBJ biquad in and returns a handle, and
+  remove() frees it. The coefficients and states of all streams live in
+  contiguous arrays without gaps. process() runs a block of every stream in
+  SIMD batches, taking one buffer per handle.
+
+  FilterBankStages<MaxBands, MaxStages> runs many filters over one input,
+  for example the bands of a spectrum analyzer. Call setNumBands(), then
+  setBand() with each designed filter or RBJ biquad. process() writes one
+  output buffer per band, processEnergy() adds up the energy of each band,
+  and processMix() sums the bands with optional gains. The bands run side
+  by side in SIMD lanes, and each matches processing its filter alone.
+
+  With a hundred or more channels, FilterDesign and SimpleFilter can spread
+  them over several cores. Create a ChannelExecutor, which starts a set of
+  worker threads once, and pass it to setExecutor(). Each process() call then
+  splits the channels into groups of 16, runs them on the workers and the
+  calling thread, and returns when the block is done. setAffinity() pins a
+  worker to a processor. Workers stay awake briefly between blocks, so
+  block sizes of 64 to 512 samples keep them busy. The output is identical
+  to processing on one thread.
+
+  setParams() on a FilterDesign redesigns it on the spot, which may take a
+  while for Elliptic and Legendre filters and must not overlap process().
+  AsyncFilterDesign<DesignClass, Channels> takes a DesignService instead,
+  whose worker thread runs the design; a burst of changes is designed once
+  with the latest parameters. process() picks up each finished design at
+  the start of the next block without locking, and passes the input
+  through until the first one is ready. DesignService::flush() waits for
+  outstanding designs. The service must outlive the filters that use it.
+
+  Designs of the pole filter families are remembered in a process wide
+  DesignCache. A setup() call with the same family, kind, order, normalized
+  frequencies, gain, ripple and rolloff as a recent one copies the stored
+  stages and poles instead of designing again, so recalling presets is
+  cheap. DesignCache::setCapacity() bounds the number of designs kept (256
+  by default, 0 turns it off) and getStatistics() reports hits and misses.
+
 
 
 Filter family namespaces
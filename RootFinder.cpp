@@ -7,7 +7,8 @@ namespace Dsp {
 
     void RootFinderBase::solve(int degree,
         bool polish,
-        bool doSort)
+        bool doSort,
+        Method method)
     {
         assert(degree <= m_maxdegree);
 
@@ -18,6 +19,19 @@ namespace Dsp {
 
         int m = degree;
 
+        // With a polish to finish them, the Aberth roots can stop once
+        // their correction is below 1e-5 of the root, since the two Newton
+        // steps of the polish take them from there to the rounding error.
+        if (method == methodAberth && aberth(degree, polish ? 1e-5 : 0))
+        {
+            for (int j = 0; j < m; ++j)
+                if (fabs(std::imag(m_root[j])) <= 2.0 * EPS * fabs(std::real(m_root[j])))
+                    m_root[j] = complex_t(std::real(m_root[j]), 0.0);
+
+            // skip the one at a time search
+            m = 0;
+        }
+
         // copy coefficients
         for (int j = 0; j <= m; ++j)
             m_ad[j] = m_a[j];
@@ -44,9 +58,19 @@ namespace Dsp {
             }
         }
 
-        if (polish)
-            for (int j = 0; j < m; ++j)
+        // the Aberth roots have all converged on the full polynomial, one
+        // or two Newton steps there are enough to polish them
+        if (polish && m == 0)
+        {
+            for (int j = 0; j < degree; ++j)
+                if (newton(degree, m_root[j]))
+                    newton(degree, m_root[j]);
+        }
+        else if (polish)
+        {
+            for (int j = 0; j < degree; ++j)
                 laguerre(degree, m_a, m_root[j], its);
+        }
 
         if (doSort)
             sort(degree);
@@ -73,6 +97,223 @@ namespace Dsp {
 
     //------------------------------------------------------------------------------
 
+    // (ar + i ai) / (br + i bi) by Smith's method, which does not
+    // overflow for large values of f
+    static inline void divide(double ar, double ai, double br, double bi,
+        double& qr, double& qi)
+    {
+        if (fabs(br) >= fabs(bi))
+        {
+            const double r = bi / br;
+            const double d = 1 / (br + bi * r);
+            qr = (ar + ai * r) * d;
+            qi = (ai - ar * r) * d;
+        }
+        else
+        {
+            const double r = br / bi;
+            const double d = 1 / (br * r + bi);
+            qr = (ar * r + ai) * d;
+            qi = (ai * r - ar) * d;
+        }
+    }
+
+    bool RootFinderBase::aberth(int degree, double tolerance)
+    {
+        const int MAXIT = 100;
+        const double EPS = std::numeric_limits<double>::epsilon();
+
+        const int m = degree;
+        if (m < 1 || m_a[m] == 0.)
+            return false;
+
+        // Start on a circle with the geometric mean radius of the roots,
+        // turned so that no guess lies on a line of symmetry
+        double radius = std::abs(m_a[0]) > 0. ?
+            pow(std::abs(m_a[0] / m_a[m]), 1. / m) : 1.;
+        if (!(radius > 0.) || radius == std::numeric_limits<double>::infinity())
+            radius = 1;
+        for (int k = 0; k < m; ++k)
+            m_root[k] = std::polar(radius, (2 * doublePi * k) / m + 0.4);
+
+        // m_ad is free until deflation. It holds the magnitude of each
+        // coefficient for the error bound, and whether each root has
+        // converged. The inner loops are written out in real arithmetic,
+        // since the complex library operators check for infinities on
+        // every call.
+        for (int j = 0; j <= m; ++j)
+            m_ad[j] = complex_t(std::abs(m_a[j]), 0.);
+
+        int remaining = m;
+        for (int iter = 0; iter < MAXIT && remaining > 0; ++iter)
+        {
+            for (int k = 0; k < m; ++k)
+            {
+                if (m_ad[k].imag() != 0.)
+                    continue;
+
+                // f and f' at z by Horner's rule, and a bound on the
+                // rounding error of f
+                const double zr = m_root[k].real();
+                const double zi = m_root[k].imag();
+                const double abz = std::sqrt(zr * zr + zi * zi);
+                double br = m_a[m].real();
+                double bi = m_a[m].imag();
+                double dr = 0;
+                double di = 0;
+                double err = m_ad[m].real();
+                for (int j = m - 1; j >= 0; --j)
+                {
+                    const double tr = zr * dr - zi * di + br;
+                    di = zr * di + zi * dr + bi;
+                    dr = tr;
+                    const double ur = zr * br - zi * bi + m_a[j].real();
+                    bi = zr * bi + zi * br + m_a[j].imag();
+                    br = ur;
+                    err = abz * err + m_ad[j].real();
+                }
+
+                if (std::max(fabs(br), fabs(bi)) <= err * EPS)
+                {
+                    m_ad[k].imag(1.);
+                    --remaining;
+                    continue;
+                }
+
+                // sum of 1 / (z - zj) over the other roots
+                double sr = 0;
+                double si = 0;
+                for (int j = 0; j < m; ++j)
+                {
+                    if (j == k)
+                        continue;
+                    const double er = zr - m_root[j].real();
+                    const double ei = zi - m_root[j].imag();
+                    const double s = 1 / (er * er + ei * ei);
+                    sr += er * s;
+                    si -= ei * s;
+                }
+
+                // ratio = f / f', w = ratio / (1 - ratio * sum)
+                double rr, ri;
+                divide(br, bi, dr, di, rr, ri);
+                const double qr = 1 - (rr * sr - ri * si);
+                const double qi = -(rr * si + ri * sr);
+                double wr, wi;
+                divide(rr, ri, qr, qi, wr, wi);
+
+                if (!(std::max(fabs(wr), fabs(wi)) > std::max(EPS, tolerance) * abz))
+                {
+                    m_ad[k].imag(1.);
+                    --remaining;
+                }
+                m_root[k] = complex_t(zr - wr, zi - wi);
+            }
+        }
+
+        for (int k = 0; k < m; ++k)
+            if (Dsp::is_nan(m_root[k]))
+                return false;
+
+        return remaining == 0;
+    }
+
+    //------------------------------------------------------------------------------
+
+    // s + e = a + b exactly
+    static inline void twoSum(double a, double b, double& s, double& e)
+    {
+        s = a + b;
+        const double bb = s - a;
+        e = (a - (s - bb)) + (b - bb);
+    }
+
+    // h + l = a, with h and l short enough that their products are exact
+    static inline void split(double a, double& h, double& l)
+    {
+        const double c = 134217729. * a; // 2^27 + 1
+        h = c - (c - a);
+        l = a - h;
+    }
+
+    // The rounding error of a * b = p, from the split halves of a and b
+    static inline double productError(double p,
+        double ah, double al, double bh, double bl)
+    {
+        return ((ah * bh - p) + ah * bl + al * bh) + al * bl;
+    }
+
+    bool RootFinderBase::newton(int degree,
+        complex_t& x)
+    {
+        const int m = degree;
+        const double zr = x.real();
+        const double zi = x.imag();
+
+        // Horner's rule for f, carrying the rounding error of every step
+        // in (cr, ci), which makes f about as accurate as if it were
+        // evaluated in twice the precision. f' needs no more than double.
+        double zrh, zrl, zih, zil;
+        split(zr, zrh, zrl);
+        split(zi, zih, zil);
+
+        double br = m_a[m].real();
+        double bi = m_a[m].imag();
+        double cr = 0;
+        double ci = 0;
+        double dr = 0;
+        double di = 0;
+        for (int j = m - 1; j >= 0; --j)
+        {
+            const double tr = zr * dr - zi * di + br;
+            di = zr * di + zi * dr + bi;
+            dr = tr;
+
+            double brh, brl, bih, bil;
+            split(br, brh, brl);
+            split(bi, bih, bil);
+            const double p1 = zr * br;
+            const double p2 = zi * bi;
+            const double p3 = zr * bi;
+            const double p4 = zi * br;
+            const double e1 = productError(p1, zrh, zrl, brh, brl);
+            const double e2 = productError(p2, zih, zil, bih, bil);
+            const double e3 = productError(p3, zrh, zrl, bih, bil);
+            const double e4 = productError(p4, zih, zil, brh, brl);
+
+            double sr, s1, si, s2, ur, u1, ui, u2;
+            twoSum(p1, -p2, sr, s1);
+            twoSum(p3, p4, si, s2);
+            twoSum(sr, m_a[j].real(), ur, u1);
+            twoSum(si, m_a[j].imag(), ui, u2);
+
+            const double vr = zr * cr - zi * ci + (e1 - e2 + s1 + u1);
+            ci = zr * ci + zi * cr + (e3 + e4 + s2 + u2);
+            cr = vr;
+            br = ur;
+            bi = ui;
+        }
+
+        const double fr = br + cr;
+        const double fi = bi + ci;
+        if ((fr == 0 && fi == 0) || (dr == 0 && di == 0))
+            return false;
+
+        double wr, wi;
+        divide(fr, fi, dr, di, wr, wi);
+        const complex_t y(zr - wr, zi - wi);
+        if (Dsp::is_nan(y))
+            return false;
+
+        // the next step would be about the square of this one
+        x = y;
+        return std::max(fabs(wr), fabs(wi)) >
+            std::sqrt(std::numeric_limits<double>::epsilon()) *
+            std::max(fabs(zr), fabs(zi));
+    }
+
+    //------------------------------------------------------------------------------
+
     void RootFinderBase::laguerre(int degree,
         complex_t a[],
         complex_t& x,
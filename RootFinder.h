@@ -27,6 +27,20 @@ namespace Dsp {
             //};
         };
 
+        // How solve() finds the roots
+        enum Method
+        {
+            // One root at a time with Laguerre's method, deflating after each
+            methodLaguerre,
+
+            // All roots at once with the Aberth-Ehrlich iteration, which is
+            // faster for most degrees. The polish is Newton's method on the
+            // polynomial evaluated in compensated arithmetic, which takes
+            // the roots to those of the coefficients as given. Falls back
+            // to methodLaguerre if it does not converge.
+            methodAberth
+        };
+
         //
         // Find roots of polynomial f(x)=a[0]+a[1]*x+a[2]*x^2...+a[degree]*x^degree
         // The input coefficients are set using coef()[].
@@ -34,7 +48,8 @@ namespace Dsp {
         //
         void solve(int degree,
             bool polish = true,
-            bool doSort = true);
+            bool doSort = true,
+            Method method = methodLaguerre);
 
         // Evaluates the polynomial at x
         complex_t eval(int degree,
@@ -56,6 +71,17 @@ namespace Dsp {
         void sort(int degree);
 
     private:
+        // Finds all roots at once into m_root, returns false if the
+        // iteration did not converge. A root is done once its correction
+        // is below tolerance relative to it, or the rounding error.
+        bool aberth(int degree, double tolerance);
+
+        // Improves x as a root with one Newton step, evaluating the
+        // polynomial in compensated arithmetic. Returns false if another
+        // step would be within the rounding error of x.
+        bool newton(int degree,
+            complex_t& x);
+
         // Improves x as a root using Laguerre's method.
         // The input coefficient array has degree+1 elements.
         void laguerre(int degree,
@@ -0,0 +1,970 @@
+#ifndef DSPFILTERS_SIMD_H
+#define DSPFILTERS_SIMD_H
+
+#include "Common.h"
+#include "MathSupplement.h"
+
+//
+// Select the vector instruction sets available to the compiler. MSVC only
+// defines __AVX__ and __AVX512F__ for the matching /arch switch, and always
+// supports SSE2 on x64. These decide Simd::Native, so every translation unit
+// of a build has to see the same ones.
+//
+
+#if !defined(DSPFILTERS_SIMD_SSE2) && \
+    (defined(_M_X64) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#  define DSPFILTERS_SIMD_SSE2 1
+#endif
+
+#if !defined(DSPFILTERS_SIMD_AVX) && defined(__AVX__)
+#  define DSPFILTERS_SIMD_AVX 1
+#endif
+
+#if !defined(DSPFILTERS_SIMD_AVX512) && defined(__AVX512F__)
+#  define DSPFILTERS_SIMD_AVX512 1
+#endif
+
+//
+// The AVX and AVX-512 wrappers are declared on every x86 build, for the
+// kernels of DispatchAvx.cpp and DispatchAvx512.cpp. Their functions are
+// compiled for those instruction sets through the target attribute, which
+// leaves the rest of the program on the baseline one. MSVC accepts the
+// intrinsics anywhere and needs no attribute.
+//
+
+#if defined(DSPFILTERS_SIMD_SSE2) && !defined(DSPFILTERS_SIMD_WIDE) && \
+    (defined(_MSC_VER) || defined(__GNUC__))
+#  define DSPFILTERS_SIMD_WIDE 1
+#endif
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#  define DSPFILTERS_TARGET_AVX
+#  define DSPFILTERS_TARGET_AVX512
+#  define DSPFILTERS_FLATTEN
+#else
+#  define DSPFILTERS_TARGET_AVX __attribute__((target("avx")))
+#  define DSPFILTERS_TARGET_AVX512 __attribute__((target("avx512f")))
+#  define DSPFILTERS_FLATTEN __attribute__((flatten))
+#endif
+
+// GCC contracts a * b + c into a fused multiply-add by default wherever the
+// target has one, as AVX-512 does, and then a lane no longer computes the
+// same result as the scalar code. Clang keeps the intrinsics apart and MSVC
+// only fuses under /fp:fast. Only the dispatched kernels are marked: on the
+// scalar forms the attribute would keep GCC from inlining them, so a build
+// whose own target has FMA (-mfma, -march=native) fuses the scalar code
+// unless it passes -ffp-contract=off.
+#if defined(__GNUC__) && !defined(__clang__)
+#  define DSPFILTERS_NO_CONTRACT __attribute__((optimize("fp-contract=off")))
+#else
+#  define DSPFILTERS_NO_CONTRACT
+#endif
+
+// The kernels for them rely on the lane templates being inlined, see
+// DispatchKernels.h. Unoptimized GCC and Clang builds inline nothing and
+// would pass the wide vectors between functions that disagree on how, so
+// they go without.
+#if defined(DSPFILTERS_SIMD_WIDE) && !defined(DSPFILTERS_SIMD_WIDE_KERNELS) && \
+    ((defined(_MSC_VER) && !defined(__clang__)) || defined(__OPTIMIZE__))
+#  define DSPFILTERS_SIMD_WIDE_KERNELS 1
+#endif
+
+#if defined(DSPFILTERS_SIMD_SSE2)
+#  include <emmintrin.h>
+#endif
+
+#if defined(DSPFILTERS_SIMD_WIDE)
+#  include <immintrin.h>
+#endif
+
+namespace Dsp {
+
+    /*
+     * Thin wrappers around the vector registers used by the lane-parallel
+     * processing kernels. Each wrapper holds Vec::lanes values of type
+     * Vec::value_type and only provides the handful of operations the
+     * kernels need. Arithmetic is
+     * never fused or reordered, so a lane computes bit-for-bit the same
+     * result as the scalar code it mirrors, as long as that is not fused
+     * either (see DSPFILTERS_NO_CONTRACT).
+     *
+     */
+
+    namespace Simd {
+
+        // One lane, used for the left-over channels and as a fallback
+        struct Scalar
+        {
+            typedef double value_type;
+
+            enum
+            {
+                lanes = 1
+            };
+
+            typedef void Narrower;
+
+            Scalar() { }
+            Scalar(double v_) : v(v_) { }
+
+            static Scalar broadcast(double x) { return Scalar(x); }
+            static Scalar load(const double* p) { return Scalar(*p); }
+            void store(double* p) const { *p = v; }
+
+            double v;
+        };
+
+        inline Scalar operator+ (const Scalar& a, const Scalar& b) { return a.v + b.v; }
+        inline Scalar operator- (const Scalar& a, const Scalar& b) { return a.v - b.v; }
+        inline Scalar operator* (const Scalar& a, const Scalar& b) { return a.v * b.v; }
+
+        // Shifts every lane up by one, dropping the last lane and
+        // putting x in the first one.
+        inline Scalar shiftIn(const Scalar&, double x) { return x; }
+
+        // Value of the last lane
+        inline double lastLane(const Scalar& a) { return a.v; }
+
+        //------------------------------------------------------------------------------
+
+#ifdef DSPFILTERS_SIMD_SSE2
+        struct Sse2
+        {
+            typedef double value_type;
+
+            enum
+            {
+                lanes = 2
+            };
+
+            typedef Scalar Narrower;
+
+            Sse2() { }
+            Sse2(__m128d v_) : v(v_) { }
+
+            static Sse2 broadcast(double x) { return _mm_set1_pd(x); }
+            static Sse2 load(const double* p) { return _mm_loadu_pd(p); }
+            void store(double* p) const { _mm_storeu_pd(p, v); }
+
+            __m128d v;
+        };
+
+        inline Sse2 operator+ (const Sse2& a, const Sse2& b) { return _mm_add_pd(a.v, b.v); }
+        inline Sse2 operator- (const Sse2& a, const Sse2& b) { return _mm_sub_pd(a.v, b.v); }
+        inline Sse2 operator* (const Sse2& a, const Sse2& b) { return _mm_mul_pd(a.v, b.v); }
+
+        inline Sse2 shiftIn(const Sse2& a, double x)
+        {
+            return _mm_unpacklo_pd(_mm_set_sd(x), a.v);
+        }
+
+        inline double lastLane(const Sse2& a)
+        {
+            return _mm_cvtsd_f64(_mm_unpackhi_pd(a.v, a.v));
+        }
+#endif
+
+        //------------------------------------------------------------------------------
+
+#ifdef DSPFILTERS_SIMD_WIDE
+        struct Avx
+        {
+            typedef double value_type;
+
+            enum
+            {
+                lanes = 4
+            };
+
+            typedef Sse2 Narrower;
+
+            DSPFILTERS_TARGET_AVX Avx() { }
+            DSPFILTERS_TARGET_AVX Avx(__m256d v_) : v(v_) { }
+
+            DSPFILTERS_TARGET_AVX static Avx broadcast(double x) { return _mm256_set1_pd(x); }
+            DSPFILTERS_TARGET_AVX static Avx load(const double* p) { return _mm256_loadu_pd(p); }
+            DSPFILTERS_TARGET_AVX void store(double* p) const { _mm256_storeu_pd(p, v); }
+
+            __m256d v;
+        };
+
+        DSPFILTERS_TARGET_AVX inline Avx operator+ (const Avx& a, const Avx& b) { return _mm256_add_pd(a.v, b.v); }
+        DSPFILTERS_TARGET_AVX inline Avx operator- (const Avx& a, const Avx& b) { return _mm256_sub_pd(a.v, b.v); }
+        DSPFILTERS_TARGET_AVX inline Avx operator* (const Avx& a, const Avx& b) { return _mm256_mul_pd(a.v, b.v); }
+
+        DSPFILTERS_TARGET_AVX inline Avx shiftIn(const Avx& a, double x)
+        {
+            // { 0, 0, a0, a1 } then pick { -, a0, a1, a2 } and insert x
+            const __m256d t = _mm256_permute2f128_pd(a.v, a.v, 0x08);
+            return _mm256_blend_pd(_mm256_shuffle_pd(t, a.v, 0x4),
+                _mm256_set1_pd(x), 0x1);
+        }
+
+        DSPFILTERS_TARGET_AVX inline double lastLane(const Avx& a)
+        {
+            return lastLane(Sse2(_mm256_extractf128_pd(a.v, 1)));
+        }
+#endif
+
+        //------------------------------------------------------------------------------
+
+#ifdef DSPFILTERS_SIMD_WIDE
+        struct Avx512
+        {
+            typedef double value_type;
+
+            enum
+            {
+                lanes = 8
+            };
+
+            typedef Avx Narrower;
+
+            DSPFILTERS_TARGET_AVX512 Avx512() { }
+            DSPFILTERS_TARGET_AVX512 Avx512(__m512d v_) : v(v_) { }
+
+            DSPFILTERS_TARGET_AVX512 static Avx512 broadcast(double x) { return _mm512_set1_pd(x); }
+            DSPFILTERS_TARGET_AVX512 static Avx512 load(const double* p) { return _mm512_loadu_pd(p); }
+            DSPFILTERS_TARGET_AVX512 void store(double* p) const { _mm512_storeu_pd(p, v); }
+
+            __m512d v;
+        };
+
+        DSPFILTERS_TARGET_AVX512 inline Avx512 operator+ (const Avx512& a, const Avx512& b) { return _mm512_add_pd(a.v, b.v); }
+        DSPFILTERS_TARGET_AVX512 inline Avx512 operator- (const Avx512& a, const Avx512& b) { return _mm512_sub_pd(a.v, b.v); }
+        DSPFILTERS_TARGET_AVX512 inline Avx512 operator* (const Avx512& a, const Avx512& b) { return _mm512_mul_pd(a.v, b.v); }
+
+        DSPFILTERS_TARGET_AVX512 inline Avx512 shiftIn(const Avx512& a, double x)
+        {
+            return _mm512_castsi512_pd(_mm512_alignr_epi64(
+                _mm512_castpd_si512(a.v),
+                _mm512_castpd_si512(_mm512_set1_pd(x)), 7));
+        }
+
+        DSPFILTERS_TARGET_AVX512 inline double lastLane(const Avx512& a)
+        {
+            return lastLane(Avx(_mm512_extractf64x4_pd(a.v, 1)));
+        }
+#endif
+
+        //------------------------------------------------------------------------------
+
+        // The widest vector the compiler was allowed to use
+#if defined(DSPFILTERS_SIMD_AVX512)
+        typedef Avx512 Native;
+#elif defined(DSPFILTERS_SIMD_AVX)
+        typedef Avx Native;
+#elif defined(DSPFILTERS_SIMD_SSE2)
+        typedef Sse2 Native;
+#else
+        typedef Scalar Native;
+#endif
+
+        //------------------------------------------------------------------------------
+
+        //
+        // Single precision wrappers, twice as many lanes per register
+        //
+
+        struct ScalarFloat
+        {
+            typedef float value_type;
+
+            enum
+            {
+                lanes = 1
+            };
+
+            typedef void Narrower;
+
+            ScalarFloat() { }
+            ScalarFloat(float v_) : v(v_) { }
+
+            static ScalarFloat broadcast(float x) { return ScalarFloat(x); }
+            static ScalarFloat load(const float* p) { return ScalarFloat(*p); }
+            void store(float* p) const { *p = v; }
+
+            float v;
+        };
+
+        inline ScalarFloat operator+ (const ScalarFloat& a, const ScalarFloat& b) { return a.v + b.v; }
+        inline ScalarFloat operator- (const ScalarFloat& a, const ScalarFloat& b) { return a.v - b.v; }
+        inline ScalarFloat operator* (const ScalarFloat& a, const ScalarFloat& b) { return a.v * b.v; }
+
+#ifdef DSPFILTERS_SIMD_SSE2
+        struct Sse2Float
+        {
+            typedef float value_type;
+
+            enum
+            {
+                lanes = 4
+            };
+
+            typedef ScalarFloat Narrower;
+
+            Sse2Float() { }
+            Sse2Float(__m128 v_) : v(v_) { }
+
+            static Sse2Float broadcast(float x) { return _mm_set1_ps(x); }
+            static Sse2Float load(const float* p) { return _mm_loadu_ps(p); }
+            void store(float* p) const { _mm_storeu_ps(p, v); }
+
+            __m128 v;
+        };
+
+        inline Sse2Float operator+ (const Sse2Float& a, const Sse2Float& b) { return _mm_add_ps(a.v, b.v); }
+        inline Sse2Float operator- (const Sse2Float& a, const Sse2Float& b) { return _mm_sub_ps(a.v, b.v); }
+        inline Sse2Float operator* (const Sse2Float& a, const Sse2Float& b) { return _mm_mul_ps(a.v, b.v); }
+#endif
+
+#ifdef DSPFILTERS_SIMD_WIDE
+        struct AvxFloat
+        {
+            typedef float value_type;
+
+            enum
+            {
+                lanes = 8
+            };
+
+            typedef Sse2Float Narrower;
+
+            DSPFILTERS_TARGET_AVX AvxFloat() { }
+            DSPFILTERS_TARGET_AVX AvxFloat(__m256 v_) : v(v_) { }
+
+            DSPFILTERS_TARGET_AVX static AvxFloat broadcast(float x) { return _mm256_set1_ps(x); }
+            DSPFILTERS_TARGET_AVX static AvxFloat load(const float* p) { return _mm256_loadu_ps(p); }
+            DSPFILTERS_TARGET_AVX void store(float* p) const { _mm256_storeu_ps(p, v); }
+
+            __m256 v;
+        };
+
+        DSPFILTERS_TARGET_AVX inline AvxFloat operator+ (const AvxFloat& a, const AvxFloat& b) { return _mm256_add_ps(a.v, b.v); }
+        DSPFILTERS_TARGET_AVX inline AvxFloat operator- (const AvxFloat& a, const AvxFloat& b) { return _mm256_sub_ps(a.v, b.v); }
+        DSPFILTERS_TARGET_AVX inline AvxFloat operator* (const AvxFloat& a, const AvxFloat& b) { return _mm256_mul_ps(a.v, b.v); }
+#endif
+
+#ifdef DSPFILTERS_SIMD_WIDE
+        struct Avx512Float
+        {
+            typedef float value_type;
+
+            enum
+            {
+                lanes = 16
+            };
+
+            typedef AvxFloat Narrower;
+
+            DSPFILTERS_TARGET_AVX512 Avx512Float() { }
+            DSPFILTERS_TARGET_AVX512 Avx512Float(__m512 v_) : v(v_) { }
+
+            DSPFILTERS_TARGET_AVX512 static Avx512Float broadcast(float x) { return _mm512_set1_ps(x); }
+            DSPFILTERS_TARGET_AVX512 static Avx512Float load(const float* p) { return _mm512_loadu_ps(p); }
+            DSPFILTERS_TARGET_AVX512 void store(float* p) const { _mm512_storeu_ps(p, v); }
+
+            __m512 v;
+        };
+
+        DSPFILTERS_TARGET_AVX512 inline Avx512Float operator+ (const Avx512Float& a, const Avx512Float& b) { return _mm512_add_ps(a.v, b.v); }
+        DSPFILTERS_TARGET_AVX512 inline Avx512Float operator- (const Avx512Float& a, const Avx512Float& b) { return _mm512_sub_ps(a.v, b.v); }
+        DSPFILTERS_TARGET_AVX512 inline Avx512Float operator* (const Avx512Float& a, const Avx512Float& b) { return _mm512_mul_ps(a.v, b.v); }
+#endif
+
+#if defined(DSPFILTERS_SIMD_AVX512)
+        typedef Avx512Float NativeFloat;
+#elif defined(DSPFILTERS_SIMD_AVX)
+        typedef AvxFloat NativeFloat;
+#elif defined(DSPFILTERS_SIMD_SSE2)
+        typedef Sse2Float NativeFloat;
+#else
+        typedef ScalarFloat NativeFloat;
+#endif
+
+        //------------------------------------------------------------------------------
+
+        // Vector types for values of the given precision
+        template <typename Value>
+        struct Vectors
+        {
+            typedef Native native_t;
+            typedef Scalar scalar_t;
+        };
+
+        template <>
+        struct Vectors <float>
+        {
+            typedef NativeFloat native_t;
+            typedef ScalarFloat scalar_t;
+        };
+
+        // One lane of an integer type. The fixed point forms have no
+        // vector kernels, their channels run one at a time. The multiplies
+        // exist, _mm_madd_epi16 in SSE2 for Q15 and _mm_mul_epi32 in
+        // SSE4.1 or _mm256_mul_epi32 in AVX2 for Q31, but matching the 64
+        // bit accumulator of BasicDirectFormIFixed also needs 64 bit
+        // arithmetic shifts and compares for the rounding and saturation,
+        // which would have to be emulated below AVX-512.
+        template <typename Value>
+        struct Single
+        {
+            typedef Value value_type;
+
+            enum
+            {
+                lanes = 1
+            };
+
+            typedef void Narrower;
+
+            Single() { }
+            Single(Value v_) : v(v_) { }
+
+            static Single broadcast(Value x) { return Single(x); }
+            static Single load(const Value* p) { return Single(*p); }
+            void store(Value* p) const { *p = v; }
+
+            Value v;
+        };
+
+        template <typename Value>
+        inline Single<Value> operator+ (const Single<Value>& a, const Single<Value>& b) { return Value(a.v + b.v); }
+        template <typename Value>
+        inline Single<Value> operator- (const Single<Value>& a, const Single<Value>& b) { return Value(a.v - b.v); }
+        template <typename Value>
+        inline Single<Value> operator* (const Single<Value>& a, const Single<Value>& b) { return Value(a.v * b.v); }
+
+        template <>
+        struct Vectors <int16_t>
+        {
+            typedef Single<int16_t> native_t;
+            typedef Single<int16_t> scalar_t;
+        };
+
+        template <>
+        struct Vectors <int32_t>
+        {
+            typedef Single<int32_t> native_t;
+            typedef Single<int32_t> scalar_t;
+        };
+
+        // The widest vector, no wider than Native, whose lanes fit in
+        // a block of the given number of samples
+        template <int Samples, class Vec = Native,
+            bool Fits = (int(Vec::lanes) <= Samples)>
+        struct Fit
+        {
+            typedef Vec type;
+        };
+
+        template <int Samples, class Vec>
+        struct Fit <Samples, Vec, false>
+        {
+            typedef typename Fit <Samples, typename Vec::Narrower>::type type;
+        };
+
+    }
+
+    //------------------------------------------------------------------------------
+
+    class BiquadBase;
+
+    template <typename Value>
+    struct BiquadCoefficients;
+
+    // Vector types matching the precision a state form computes in
+    template <class StateType>
+    struct LaneVectors : Simd::Vectors <typename StateType::value_type>
+    {
+    };
+
+    /*
+     * Lane-parallel processing
+     *
+     * A LaneState<StateType, Vec> holds the state of one second order section
+     * for Vec::lanes independent channels, one channel per lane. Its process1
+     * takes the place of StateType::process1 for a whole vector of samples.
+     * Specializations in State.h implement the forms with vector arithmetic
+     * that mirrors the scalar expressions exactly; this generic version keeps
+     * a copy of each lane's state and runs it through StateType::process1.
+     *
+     */
+
+    // Coefficients of one second order section, broadcast to every lane
+    template <class Vec>
+    struct LaneBiquad
+    {
+        typedef typename Vec::value_type value_type;
+
+        template <class BiquadType>
+        void set(const BiquadType& s)
+        {
+            const BiquadCoefficients<value_type> c(s);
+            b0 = Vec::broadcast(c.b0);
+            b1 = Vec::broadcast(c.b1);
+            b2 = Vec::broadcast(c.b2);
+            a1 = Vec::broadcast(c.a1);
+            a2 = Vec::broadcast(c.a2);
+        }
+
+        // A different section in each lane
+        template <class BiquadType>
+        void setLanes(const BiquadType* const* sections)
+        {
+            value_type t[5][Vec::lanes];
+            for (int i = 0; i < Vec::lanes; ++i)
+            {
+                const BiquadCoefficients<value_type> c(*sections[i]);
+                t[0][i] = c.b0;
+                t[1][i] = c.b1;
+                t[2][i] = c.b2;
+                t[3][i] = c.a1;
+                t[4][i] = c.a2;
+            }
+            b0 = Vec::load(t[0]);
+            b1 = Vec::load(t[1]);
+            b2 = Vec::load(t[2]);
+            a1 = Vec::load(t[3]);
+            a2 = Vec::load(t[4]);
+        }
+
+        Vec b0;
+        Vec b1;
+        Vec b2;
+        Vec a1;
+        Vec a2;
+    };
+
+    template <class StateType, class Vec>
+    struct LaneState
+    {
+        void load(StateType* const* stateArrays, int stage)
+        {
+            for (int i = 0; i < Vec::lanes; ++i)
+                m_state[i] = stateArrays[i][stage];
+        }
+
+        void store(StateType* const* stateArrays, int stage) const
+        {
+            for (int i = 0; i < Vec::lanes; ++i)
+                stateArrays[i][stage] = m_state[i];
+        }
+
+        Vec process1(const Vec& in, const LaneBiquad<Vec>& s, const Vec& vsa)
+        {
+            typedef typename Vec::value_type value_type;
+
+            value_type x[Vec::lanes];
+            value_type v[Vec::lanes];
+            value_type t[5][Vec::lanes];
+            in.store(x);
+            vsa.store(v);
+            s.b0.store(t[0]);
+            s.b1.store(t[1]);
+            s.b2.store(t[2]);
+            s.a1.store(t[3]);
+            s.a2.store(t[4]);
+            for (int i = 0; i < Vec::lanes; ++i)
+            {
+                BiquadCoefficients<value_type> c;
+                c.b0 = t[0][i];
+                c.b1 = t[1][i];
+                c.b2 = t[2][i];
+                c.a1 = t[3][i];
+                c.a2 = t[4][i];
+                x[i] = m_state[i].process1(x[i], c, v[i]);
+            }
+            return Vec::load(x);
+        }
+
+    private:
+        StateType m_state[Vec::lanes];
+    };
+
+    // Gathers one member of each lane's state into a vector
+    template <class Vec, class StateType>
+    inline Vec loadLanes(StateType* const* stateArrays,
+        int stage,
+        typename Vec::value_type StateType::* member)
+    {
+        typename Vec::value_type v[Vec::lanes];
+        for (int i = 0; i < Vec::lanes; ++i)
+            v[i] = stateArrays[i][stage].*member;
+        return Vec::load(v);
+    }
+
+    // Scatters a vector back into one member of each lane's state
+    template <class Vec, class StateType>
+    inline void storeLanes(StateType* const* stateArrays,
+        int stage,
+        typename Vec::value_type StateType::* member,
+        const Vec& x)
+    {
+        typename Vec::value_type v[Vec::lanes];
+        x.store(v);
+        for (int i = 0; i < Vec::lanes; ++i)
+            stateArrays[i][stage].*member = v[i];
+    }
+
+    // The sections of a different cascade in each lane, stageArrays[i]
+    // being the stages of lane i. Stands in for a plain stage array in
+    // processLanes, see StreamPool.
+    template <class Stage>
+    struct LaneStages
+    {
+        explicit LaneStages(const Stage* const* stageArrays_)
+            : stageArrays(stageArrays_)
+        {
+        }
+
+        const Stage* const* stageArrays;
+    };
+
+    template <class Vec, class Stage>
+    inline void setSection(LaneBiquad<Vec>& section,
+        const Stage* stageArray,
+        int stage)
+    {
+        section.set(stageArray[stage]);
+    }
+
+    template <class Vec, class Stage>
+    inline void setSection(LaneBiquad<Vec>& section,
+        const LaneStages<Stage>& stages,
+        int stage)
+    {
+        const Stage* sections[Vec::lanes];
+        for (int i = 0; i < Vec::lanes; ++i)
+            sections[i] = stages.stageArrays[i] + stage;
+        section.setLanes(sections);
+    }
+
+    // Sections that change every sample, the same in every lane. The
+    // numStages stages of sample n follow those of sample n - 1 in stages.
+    // Stands in for a plain stage array in processLanes, see
+    // SmoothedFilterDesign.
+    template <class Stage>
+    struct StageTrajectory
+    {
+        StageTrajectory(const Stage* stages_, int numStages_)
+            : stages(stages_)
+            , numStages(numStages_)
+        {
+        }
+
+        const Stage* stages;
+        int numStages;
+    };
+
+    // Set for each frame instead, see setFrameSections
+    template <class Vec, class Stage>
+    inline void setSection(LaneBiquad<Vec>&,
+        const StageTrajectory<Stage>&,
+        int)
+    {
+    }
+
+    // Sets count sections from stage first on for frame n. Only sections
+    // that change every sample have anything to do.
+    template <class Vec, class StageArray>
+    inline void setFrameSections(LaneBiquad<Vec>*,
+        const StageArray&,
+        int,
+        int,
+        int)
+    {
+    }
+
+    template <class Vec, class Stage>
+    inline void setFrameSections(LaneBiquad<Vec>* section,
+        const StageTrajectory<Stage>& trajectory,
+        int n,
+        int first,
+        int count)
+    {
+        const Stage* stage = trajectory.stages + n * trajectory.numStages + first;
+        for (int k = 0; k < count; ++k)
+            section[k].set(stage[k]);
+    }
+
+    // Process a block of samples for Vec::lanes channels through a cascade
+    // of numStages sections. stateArrays[i] points to the state array of
+    // channel i. stageArray is an array of sections shared by the lanes,
+    // LaneStages for a cascade of their own, or StageTrajectory for
+    // sections that change every sample. The channels are transposed into frames a chunk at a time,
+    // and each frame then walks the stages exactly like the scalar code,
+    // so the output is identical to processing the channels one by one.
+    //
+    // Consecutive samples of a channel are stride apart: 1 for planar
+    // buffers, the frame size for interleaved ones. When the channels are
+    // exactly the frames of an interleaved buffer, frames are copied as is.
+    //
+    // The input is read from sourceChannels, which may be arrayOfChannels
+    // itself, and converted to Sample on the way in, so the output is the
+    // same as copying the source into arrayOfChannels first.
+    template <class Vec, class StateType, class StageArray, typename Source, typename Sample>
+    void processLanes(int numSamples,
+        int numStages,
+        const StageArray& stageArray,
+        const Source* const* sourceChannels,
+        Sample* const* arrayOfChannels,
+        StateType* const* stateArrays,
+        DenormalPrevention* const* denormals,
+        int stride)
+    {
+        enum
+        {
+            lanes = Vec::lanes,
+            chunkFrames = 64,
+            maxStages = 16
+        };
+
+        typedef typename Vec::value_type value_type;
+
+        Vec frames[chunkFrames];
+        value_type* const data = reinterpret_cast<value_type*>(frames);
+        LaneBiquad<Vec> section[maxStages];
+        LaneState<StateType, Vec> state[maxStages];
+
+        value_type v[lanes];
+        for (int i = 0; i < lanes; ++i)
+            v[i] = static_cast<value_type>(denormals[i]->getAc());
+        Vec vsa = Vec::load(v);
+
+        const Vec negate = Vec::broadcast(-1);
+        const Vec zero = Vec::broadcast(0);
+
+        bool whole = (stride == lanes);
+        for (int i = 1; i < lanes; ++i)
+            whole = whole && arrayOfChannels[i] == arrayOfChannels[0] + i &&
+                sourceChannels[i] == sourceChannels[0] + i;
+
+        for (int offset = 0; offset < numSamples; offset += chunkFrames)
+        {
+            const int numFrames = std::min(int(chunkFrames), numSamples - offset);
+
+            if (whole)
+            {
+                const Source* src = sourceChannels[0] + offset * stride;
+                for (int n = 0; n < numFrames * lanes; ++n)
+                    data[n] = static_cast<value_type>(static_cast<Sample>(src[n]));
+            }
+            else
+            {
+                for (int i = 0; i < lanes; ++i)
+                {
+                    const Source* src = sourceChannels[i] + offset * stride;
+                    value_type* p = data + i;
+                    for (int n = numFrames; --n >= 0; p += lanes, src += stride)
+                        *p = static_cast<value_type>(static_cast<Sample>(*src));
+                }
+            }
+
+            // Very long cascades are run in groups of maxStages
+            for (int first = 0; first < numStages; first += maxStages)
+            {
+                const int count = std::min(int(maxStages), numStages - first);
+
+                for (int k = 0; k < count; ++k)
+                {
+                    setSection(section[k], stageArray, first + k);
+                    state[k].load(stateArrays, first + k);
+                }
+
+                for (int n = 0; n < numFrames; ++n)
+                {
+                    setFrameSections(section, stageArray, offset + n, first, count);
+
+                    Vec out = frames[n];
+                    int k = 0;
+                    if (first == 0)
+                    {
+                        vsa = vsa * negate;
+                        out = state[0].process1(out, section[0], vsa);
+                        ++k;
+                    }
+                    for (; k < count; ++k)
+                        out = state[k].process1(out, section[k], zero);
+                    frames[n] = out;
+                }
+
+                for (int k = 0; k < count; ++k)
+                    state[k].store(stateArrays, first + k);
+            }
+
+            if (whole)
+            {
+                Sample* dest = arrayOfChannels[0] + offset * stride;
+                for (int n = 0; n < numFrames * lanes; ++n)
+                    dest[n] = static_cast<Sample>(data[n]);
+            }
+            else
+            {
+                for (int i = 0; i < lanes; ++i)
+                {
+                    Sample* dest = arrayOfChannels[i] + offset * stride;
+                    const value_type* p = data + i;
+                    for (int n = numFrames; --n >= 0; p += lanes, dest += stride)
+                        *dest = static_cast<Sample>(*p);
+                }
+            }
+        }
+
+        vsa.store(v);
+        for (int i = 0; i < lanes; ++i)
+            denormals[i]->setAc(v[i]);
+    }
+
+    // Runs a chunk of samples through Stages consecutive stages. The stage
+    // loop has a fixed trip count so the compiler can unroll it and keep
+    // every coefficient and state word in registers, while the independent
+    // recursions of the stages overlap in the pipeline.
+    template <int Stages, class StateType, class Stage, typename Value>
+    void processStageGroup(int numSamples,
+        Value* data,
+        const Stage* stageArray,
+        StateType* stateArray,
+        Value& vsa,
+        Value flip)
+    {
+        typedef typename LaneVectors<StateType>::scalar_t Vec;
+
+        LaneBiquad<Vec> section[Stages];
+        LaneState<StateType, Vec> state[Stages];
+
+        for (int k = 0; k < Stages; ++k)
+        {
+            section[k].set(stageArray[k]);
+            state[k].load(&stateArray, k);
+        }
+
+        Value v = vsa;
+        for (int n = 0; n < numSamples; ++n)
+        {
+            v *= flip;
+            Vec x = state[0].process1(data[n], section[0], v);
+            for (int k = 1; k < Stages; ++k)
+                x = state[k].process1(x, section[k], Value(0));
+            data[n] = x.v;
+        }
+        vsa = v;
+
+        for (int k = 0; k < Stages; ++k)
+            state[k].store(&stateArray, k);
+    }
+
+    // Process a block of samples for one channel a few stages at a time:
+    // each chunk of the block runs through the first group of stages, then
+    // through the next group and so on, instead of every sample walking the
+    // whole cascade. The output is identical to the sample by sample path.
+    template <class StateType, class Stage, typename Sample>
+    void processStages(int numSamples,
+        int numStages,
+        const Stage* stageArray,
+        Sample* dest,
+        StateType* stateArray,
+        DenormalPrevention& denormal)
+    {
+        enum
+        {
+            chunkSamples = 256,
+            groupStages = 4
+        };
+
+        typedef typename StateType::value_type value_type;
+
+        value_type data[chunkSamples];
+        value_type vsa = static_cast<value_type>(denormal.getAc());
+
+        for (int offset = 0; offset < numSamples; offset += chunkSamples)
+        {
+            const int count = std::min(int(chunkSamples), numSamples - offset);
+
+            for (int n = 0; n < count; ++n)
+                data[n] = static_cast<value_type>(dest[offset + n]);
+
+            for (int k = 0; k < numStages; k += groupStages)
+            {
+                // only the first stage gets the alternating denormal offset
+                value_type none = 0;
+                value_type& v = (k == 0) ? vsa : none;
+                const value_type flip = value_type((k == 0) ? -1 : 1);
+
+                switch (std::min(int(groupStages), numStages - k))
+                {
+                case 1: processStageGroup<1>(count, data, stageArray + k, stateArray + k, v, flip); break;
+                case 2: processStageGroup<2>(count, data, stageArray + k, stateArray + k, v, flip); break;
+                case 3: processStageGroup<3>(count, data, stageArray + k, stateArray + k, v, flip); break;
+                case 4: processStageGroup<4>(count, data, stageArray + k, stateArray + k, v, flip); break;
+                };
+            }
+
+            for (int n = 0; n < count; ++n)
+                dest[offset + n] = static_cast<Sample>(data[n]);
+        }
+
+        denormal.setAc(vsa);
+    }
+
+    // Splits a set of channels into groups of Vec::lanes, handing what
+    // is left over to the next narrower vector type.
+    template <class Vec>
+    struct LaneGroups
+    {
+        template <class ChannelState, class StageArray, typename Source, typename Sample>
+        static void process(int numSamples,
+            int numChannels,
+            const Source* const* sourceChannels,
+            Sample* const* arrayOfChannels,
+            ChannelState* stateArray,
+            int numStages,
+            const StageArray& stageArray,
+            int stride = 1)
+        {
+            typedef typename ChannelState::state_type_t StateType;
+
+            for (; numChannels >= Vec::lanes; numChannels -= Vec::lanes)
+            {
+                StateType* states[Vec::lanes];
+                DenormalPrevention* denormals[Vec::lanes];
+                for (int i = 0; i < Vec::lanes; ++i)
+                {
+                    states[i] = stateArray[i].getStateArray();
+                    denormals[i] = &stateArray[i].getDenormalPrevention();
+                }
+
+                processLanes<Vec>(numSamples, numStages, stageArray,
+                    sourceChannels, arrayOfChannels, states, denormals, stride);
+
+                sourceChannels += Vec::lanes;
+                arrayOfChannels += Vec::lanes;
+                stateArray += Vec::lanes;
+            }
+
+            LaneGroups<typename Vec::Narrower>::process(numSamples,
+                numChannels, sourceChannels, arrayOfChannels, stateArray,
+                numStages, stageArray, stride);
+        }
+    };
+
+    template <>
+    struct LaneGroups <void>
+    {
+        template <class ChannelState, class StageArray, typename Source, typename Sample>
+        static void process(int,
+            int numChannels,
+            const Source* const*,
+            Sample* const*,
+            ChannelState*,
+            int,
+            const StageArray&,
+            int = 1)
+        {
+            assert(numChannels == 0);
+        }
+    };
+
+}
+
+#endif
@@ -2,6 +2,8 @@
 #define DSPFILTERS_SMOOTHEDFILTER_H
 
 #include "Common.h"
+#include "Cascade.h"
+#include "DesignCache.h"
 #include "Filter.h"
 
 namespace Dsp {
@@ -9,6 +11,19 @@ namespace Dsp {
     /*
      * Implements smooth modulation of time-varying filter parameters
      *
+     * When the parameters change, the filter glides from the old values
+     * to the new ones over transitionSamples. By default it is redesigned
+     * at every sample of the glide. With a control interval of n it is
+     * only redesigned every n samples, and the coefficients in between
+     * move on a straight line from one design to the next, the way
+     * Biquad::smoothProcess1 does. That divides the design cost of a
+     * glide by n, but the ramps follow the per sample glide less closely
+     * as n grows, most of all on fast sweeps of high order filters.
+     *
+     * The coefficients of a glide are worked out a chunk of samples at a
+     * time into a table, which the channels then run through together in
+     * SIMD lanes, as they do outside a glide.
+     *
      */
     template <class DesignClass,
         int Channels,
@@ -21,16 +36,49 @@ namespace Dsp {
     public:
         typedef FilterDesign <DesignClass, Channels, StateType> filter_type_t;
 
-        SmoothedFilterDesign(int transitionSamples)
+        explicit SmoothedFilterDesign(int transitionSamples,
+            int controlInterval = 1)
             : m_transitionSamples(transitionSamples)
             , m_remainingSamples(-1) // first time flag
+            , m_controlInterval(controlInterval)
+            , m_segmentLength(0)
+            , m_segmentRemaining(0)
+            , m_from(0)
+            , m_fromCurrent(false)
+        {
+            assert(controlInterval > 0);
+
+            // the ramps read the control designs in the precision of the form
+            compileStagesFor<value_type>(&m_controlDesigns[0]);
+            compileStagesFor<value_type>(&m_controlDesigns[1]);
+        }
+
+        int getControlInterval() const
+        {
+            return m_controlInterval;
+        }
+
+        // Redesign every controlInterval samples of a transition. Takes
+        // effect at the next control point.
+        void setControlInterval(int controlInterval)
         {
+            assert(controlInterval > 0);
+            m_controlInterval = controlInterval;
         }
 
         // Process a block of samples.
         template <typename Sample>
         void processBlock(int numSamples,
             Sample* const* destChannelArray)
+        {
+            processBlock(numSamples, destChannelArray, destChannelArray);
+        }
+
+        // Process a block out of place, reading from srcChannelArray
+        template <typename Source, typename Sample>
+        void processBlock(int numSamples,
+            const Source* const* srcChannelArray,
+            Sample* const* destChannelArray)
         {
             const int numChannels = this->getNumChannels();
 
@@ -42,24 +90,121 @@ namespace Dsp {
 
             if (remainingSamples > 0)
             {
-                // interpolate parameters for each sample
+                // interpolate parameters for each sample, designs
+                // that will not come again
+                DesignCache::Suspend suspend;
                 const double t = 1. / m_remainingSamples;
                 double dp[maxParameters];
                 for (int i = 0; i < DesignClass::NumParams; ++i)
                     dp[i] = (this->getParams()[i] - m_transitionParams[i]) * t;
 
-                for (int n = 0; n < remainingSamples; ++n)
+                // the coefficients of a chunk of samples are worked out
+                // once, then the channels run through them in SIMD lanes
+                BiquadCoefficients<value_type> trajectory[trajectoryEntries];
+                for (int n = 0; n < remainingSamples;)
                 {
-                    for (int i = DesignClass::NumParams; --i >= 0;)
-                        m_transitionParams[i] += dp[i];
+                    int numStages;
+                    const int count = makeTrajectory(remainingSamples - n,
+                        m_remainingSamples - n, dp, trajectory, numStages);
 
-                    m_transitionFilter.setParams(m_transitionParams);
+                    const Source* src[batchChannels];
+                    Sample* dest[batchChannels];
+                    for (int first = 0; first < numChannels; first += batchChannels)
+                    {
+                        const int channels = std::min(int(batchChannels),
+                            numChannels - first);
+                        for (int i = 0; i < channels; ++i)
+                        {
+                            src[i] = srcChannelArray[first + i] + n;
+                            dest[i] = destChannelArray[first + i] + n;
+                        }
+
+                        state_t::processTrajectory(count, channels, src, dest,
+                            &this->m_state[first], numStages, trajectory, 1);
+                    }
+
+                    n += count;
+                }
+
+                m_remainingSamples -= remainingSamples;
 
-                    for (int i = numChannels; --i >= 0;)
+                if (m_remainingSamples == 0)
+                    m_transitionParams = this->getParams();
+            }
+
+            // do what's left
+            if (remainingSamples == 0)
+            {
+                // no transition
+                this->m_state.process(numSamples, srcChannelArray,
+                    destChannelArray, this->m_design);
+            }
+            else if (numSamples - remainingSamples > 0)
+            {
+                // the rest of the block after a transition ends
+                const Source* src[batchChannels];
+                Sample* dest[batchChannels];
+                for (int first = 0; first < numChannels; first += batchChannels)
+                {
+                    const int channels = std::min(int(batchChannels),
+                        numChannels - first);
+                    for (int i = 0; i < channels; ++i)
                     {
-                        Sample* dest = destChannelArray[i] + n;
-                        *dest = this->m_state[i].process(*dest, m_transitionFilter);
+                        src[i] = srcChannelArray[first + i] + remainingSamples;
+                        dest[i] = destChannelArray[first + i] + remainingSamples;
                     }
+
+                    this->m_design.process(numSamples - remainingSamples,
+                        channels, src, dest, &this->m_state[first]);
+                }
+            }
+        }
+
+        // Process a block of interleaved frames.
+        template <typename Sample>
+        void processFrames(int numSamples,
+            Sample* frames,
+            int frameStride)
+        {
+            const int numChannels = this->getNumChannels();
+
+            // If this goes off it means setup() was never called
+            assert(m_remainingSamples >= 0);
+
+            // first handle any transition samples
+            int remainingSamples = std::min(m_remainingSamples, numSamples);
+
+            if (remainingSamples > 0)
+            {
+                // interpolate parameters for each sample, designs
+                // that will not come again
+                DesignCache::Suspend suspend;
+                const double t = 1. / m_remainingSamples;
+                double dp[maxParameters];
+                for (int i = 0; i < DesignClass::NumParams; ++i)
+                    dp[i] = (this->getParams()[i] - m_transitionParams[i]) * t;
+
+                BiquadCoefficients<value_type> trajectory[trajectoryEntries];
+                for (int n = 0; n < remainingSamples;)
+                {
+                    int numStages;
+                    const int count = makeTrajectory(remainingSamples - n,
+                        m_remainingSamples - n, dp, trajectory, numStages);
+
+                    Sample* channel[batchChannels];
+                    for (int first = 0; first < numChannels; first += batchChannels)
+                    {
+                        const int channels = std::min(int(batchChannels),
+                            numChannels - first);
+                        for (int i = 0; i < channels; ++i)
+                            channel[i] = frames + n * frameStride + first + i;
+
+                        state_t::processTrajectory(count, channels, channel,
+                            channel, &this->m_state[first], numStages,
+                            trajectory, frameStride);
+                    }
+
+                    n += count;
                 }
 
                 m_remainingSamples -= remainingSamples;
@@ -72,10 +217,9 @@ namespace Dsp {
             if (numSamples - remainingSamples > 0)
             {
                 // no transition
-                for (int i = 0; i < numChannels; ++i)
-                    this->m_design.process(numSamples - remainingSamples,
-                        destChannelArray[i] + remainingSamples,
-                        this->m_state[i]);
+                this->m_state.process(numSamples - remainingSamples,
+                    frames + remainingSamples * frameStride, frameStride,
+                    this->m_design);
             }
         }
 
@@ -89,12 +233,40 @@ namespace Dsp {
             processBlock(numSamples, arrayOfChannels);
         }
 
+        void process(int numSamples, float* frames, int frameStride)
+        {
+            processFrames(numSamples, frames, frameStride);
+        }
+
+        void process(int numSamples, double* frames, int frameStride)
+        {
+            processFrames(numSamples, frames, frameStride);
+        }
+
+        void process(int numSamples,
+            const float* const* sourceChannels,
+            float* const* arrayOfChannels)
+        {
+            processBlock(numSamples, sourceChannels, arrayOfChannels);
+        }
+
+        void process(int numSamples,
+            const double* const* sourceChannels,
+            double* const* arrayOfChannels)
+        {
+            processBlock(numSamples, sourceChannels, arrayOfChannels);
+        }
+
     protected:
         void doSetParams(const Params& parameters)
         {
             if (m_remainingSamples >= 0)
             {
                 m_remainingSamples = m_transitionSamples;
+
+                // start over from where the transition is now
+                m_segmentRemaining = 0;
+                m_fromCurrent = false;
             }
             else
             {
@@ -106,12 +278,131 @@ namespace Dsp {
             filter_type_t::doSetParams(parameters);
         }
 
+    private:
+        typedef typename DesignClass::template State <StateType> state_t;
+        typedef typename state_t::state_type_t::value_type value_type;
+
+        enum
+        {
+            trajectoryEntries = 256,    // most stages of a chunk of samples
+            batchChannels = 16          // a multiple of every lane count
+        };
+
+        // Moves the transition on by up to numSamples samples and puts the
+        // coefficients of each into trajectory, numStages to a sample.
+        // Returns how many it did, fewer when the number of stages changes
+        // or trajectory is full. remaining counts the samples left in the
+        // transition.
+        int makeTrajectory(int numSamples,
+            int remaining,
+            const double* dp,
+            BiquadCoefficients<value_type>* trajectory,
+            int& numStages)
+        {
+            numStages = 0;
+
+            int count = 0;
+            while (count < numSamples)
+            {
+                if (m_segmentRemaining == 0)
+                    beginSegment(remaining - count, dp);
+
+                // each sample has the stages of the next design
+                const int stages = getNumStages(m_controlDesigns[1 - m_from]);
+                assert(stages <= trajectoryEntries);
+                if (count == 0)
+                    numStages = stages;
+                else if (stages != numStages)
+                    break;
+
+                const int samples = std::min(std::min(numSamples - count,
+                    m_segmentRemaining),
+                    trajectoryEntries / std::max(numStages, 1) - count);
+                if (samples == 0)
+                    break;
+
+                advanceTransition(samples, dp, trajectory + count * numStages,
+                    numStages);
+                count += samples;
+            }
+            return count;
+        }
+
+        // At a control point, designs the filter at the next one
+        void beginSegment(int remaining, const double* dp)
+        {
+            m_segmentLength = std::min(m_controlInterval, remaining);
+            m_segmentRemaining = m_segmentLength;
+
+            // a segment of one sample does not need its start
+            if (!m_fromCurrent && m_segmentLength > 1)
+            {
+                m_controlDesigns[m_from].setParams(m_transitionParams);
+                m_fromCurrent = true;
+            }
+
+            // summed the same way as m_transitionParams
+            Params target = m_transitionParams;
+            for (int n = m_segmentLength; --n >= 0;)
+                for (int i = DesignClass::NumParams; --i >= 0;)
+                    target[i] += dp[i];
+            m_controlDesigns[1 - m_from].setParams(target);
+        }
+
+        // Moves the parameters of the transition numSamples samples on,
+        // within the current segment, and puts the coefficients of each
+        // sample into stages
+        void advanceTransition(int numSamples,
+            const double* dp,
+            BiquadCoefficients<value_type>* stages,
+            int numStages)
+        {
+            for (int n = numSamples; --n >= 0;)
+                for (int i = DesignClass::NumParams; --i >= 0;)
+                    m_transitionParams[i] += dp[i];
+
+            const DesignClass& from = m_controlDesigns[m_from];
+            const DesignClass& to = m_controlDesigns[1 - m_from];
+            const int length = m_segmentLength;
+            int segmentRemaining = m_segmentRemaining;
+            for (int n = numSamples; --n >= 0; stages += numStages)
+            {
+                --segmentRemaining;
+                DesignClass::template interpolate<value_type>(from, to,
+                    double(length - segmentRemaining) / length, stages);
+            }
+
+            m_segmentRemaining = segmentRemaining;
+            if (m_segmentRemaining == 0)
+            {
+                m_from = 1 - m_from;
+                m_fromCurrent = true;
+            }
+        }
+
+        static int getNumStages(const Cascade& c)
+        {
+            return c.getNumStages();
+        }
+
+        static int getNumStages(const BiquadBase&)
+        {
+            return 1;
+        }
+
     protected:
         Params m_transitionParams;
-        DesignClass m_transitionFilter;
         int m_transitionSamples;
 
         int m_remainingSamples;        // remaining transition samples
+
+    private:
+        int m_controlInterval;
+        DesignClass m_controlDesigns[2];    // at the last and next control point
+        int m_segmentLength;                // samples between the two
+        int m_segmentRemaining;
+        int m_from;                         // index of the last control point
+        bool m_fromCurrent;                 // false until it is designed
     };
 
 }
@@ -3,7 +3,9 @@
 
 #include "Common.h"
 #include "Biquad.h"
+#include "ChannelExecutor.h"
 
+#include <new>
 #include <stdexcept>
 
 namespace Dsp {
@@ -12,6 +14,12 @@ namespace Dsp {
      * Various forms of state information required to
      * process channels of actual sample data.
      *
+     * Each form is a template on the type of its state and arithmetic.
+     * DirectFormI and friends use double; the ...Float typedefs use float,
+     * which halves the state and fits twice the lanes in a vector register
+     * at the cost of precision. Low order and gently sloped sections are
+     * usually fine in float.
+     *
      */
 
      //------------------------------------------------------------------------------
@@ -24,10 +32,13 @@ namespace Dsp {
       *  y[n] = (b0/a0)*x[n] + (b1/a0)*x[n-1] + (b2/a0)*x[n-2]
       *                      - (a1/a0)*y[n-1] - (a2/a0)*y[n-2]
       */
-    class DirectFormI
+    template <typename Value>
+    class BasicDirectFormI
     {
     public:
-        DirectFormI()
+        typedef Value value_type;
+
+        BasicDirectFormI()
         {
             reset();
         }
@@ -40,29 +51,116 @@ namespace Dsp {
             m_y2 = 0;
         }
 
-        template <typename Sample>
+        template <typename Sample, class Section>
         inline Sample process1(const Sample in,
-            const BiquadBase& s,
+            const Section& s,
             const double vsa) // very small amount
         {
-            double out = s.m_b0 * in + s.m_b1 * m_x1 + s.m_b2 * m_x2
-                - s.m_a1 * m_y1 - s.m_a2 * m_y2
-                + vsa;
+            const BiquadCoefficients<Value> c(s);
+            const Value x = static_cast<Value>(in);
+            Value out = c.b0 * x + c.b1 * m_x1 + c.b2 * m_x2
+                - c.a1 * m_y1 - c.a2 * m_y2
+                + static_cast<Value>(vsa);
             m_x2 = m_x1;
             m_y2 = m_y1;
-            m_x1 = in;
+            m_x1 = x;
             m_y1 = out;
 
             return static_cast<Sample> (out);
         }
 
     protected:
-        double m_x2; // x[n-2]
-        double m_y2; // y[n-2]
-        double m_x1; // x[n-1]
-        double m_y1; // y[n-1]
+        template <class, class> friend struct LaneState;
+
+        Value m_x2; // x[n-2]
+        Value m_y2; // y[n-2]
+        Value m_x1; // x[n-1]
+        Value m_y1; // y[n-1]
     };
 
+    typedef BasicDirectFormI<double> DirectFormI;
+    typedef BasicDirectFormI<float> DirectFormIFloat;
+
+    //------------------------------------------------------------------------------
+
+    /*
+     * Fixed point Direct Form I for integer PCM samples
+     *
+     * The section's coefficients are used in their fixed point copies with
+     * FracBits fractional bits, Q2.14 for 16 bit and Q2.30 for 32 bit
+     * values, and the five products are summed in a 64 bit accumulator.
+     * The fraction that the shift back to Value drops is carried into the
+     * next sample (first order error feedback), so the rounding error is
+     * shaped away from low frequencies instead of being fed around the
+     * recursion. Outputs saturate to the range of Value.
+     *
+     * Samples are converted to Value as is, so use DirectFormIQ15 with
+     * 16 bit and DirectFormIQ31 with 32 bit PCM. Coefficients must lie in
+     * [-2, 2). For these forms Cascade spreads the gain of the design over
+     * its sections, so that no section's output falls far below full scale
+     * (see Cascade::copyCompiledStages). That does not help the poles:
+     * Q2.14 places them too coarsely for cutoffs below about 2% of the
+     * sample rate, where the error grows quickly (an RBJ low pass at 200 Hz
+     * and 48 kHz is off by 9% of full scale), so use Q31 there. Sections
+     * whose feedforward coefficients already span the range, as in a high
+     * pass, keep their gain and can overshoot near full scale input.
+     * getLostCoefficients() of the design counts coefficients that round
+     * to zero.
+     */
+    template <typename Value, int FracBits>
+    class BasicDirectFormIFixed
+    {
+    public:
+        typedef Value value_type;
+
+        BasicDirectFormIFixed()
+        {
+            reset();
+        }
+
+        void reset()
+        {
+            m_x1 = 0;
+            m_x2 = 0;
+            m_y1 = 0;
+            m_y2 = 0;
+            m_error = 0;
+        }
+
+        // There are no denormals, so no vsa
+        template <typename Sample, class Section>
+        inline Sample process1(const Sample in,
+            const Section& s,
+            const double)
+        {
+            const BiquadCoefficients<Value> c(s);
+            const Value x = static_cast<Value>(in);
+            const int64_t acc = m_error
+                + int64_t(c.b0) * x + int64_t(c.b1) * m_x1 + int64_t(c.b2) * m_x2
+                - int64_t(c.a1) * m_y1 - int64_t(c.a2) * m_y2;
+            const Value out = saturate<Value>(acc >> FracBits);
+            m_error = static_cast<int32_t>(acc & ((int64_t(1) << FracBits) - 1));
+            m_x2 = m_x1;
+            m_y2 = m_y1;
+            m_x1 = x;
+            m_y1 = out;
+
+            return static_cast<Sample> (out);
+        }
+
+    protected:
+        template <class, class> friend struct LaneState;
+
+        Value m_x2; // x[n-2]
+        Value m_y2; // y[n-2]
+        Value m_x1; // x[n-1]
+        Value m_y1; // y[n-1]
+        int32_t m_error; // fraction left over from y[n-1]
+    };
+
+    typedef BasicDirectFormIFixed<int16_t, 14> DirectFormIQ15;
+    typedef BasicDirectFormIFixed<int32_t, 30> DirectFormIQ31;
+
     //------------------------------------------------------------------------------
 
     /*
@@ -74,10 +172,13 @@ namespace Dsp {
      *  y(n) = (b0/a0)*v[n] + (b1/a0)*v[n-1] + (b2/a0)*v[n-2]
      *
      */
-    class DirectFormII
+    template <typename Value>
+    class BasicDirectFormII
     {
     public:
-        DirectFormII()
+        typedef Value value_type;
+
+        BasicDirectFormII()
         {
             reset();
         }
@@ -88,13 +189,15 @@ namespace Dsp {
             m_v2 = 0;
         }
 
-        template <typename Sample>
+        template <typename Sample, class Section>
         Sample process1(const Sample in,
-            const BiquadBase& s,
+            const Section& s,
             const double vsa)
         {
-            double w = in - s.m_a1 * m_v1 - s.m_a2 * m_v2 + vsa;
-            double out = s.m_b0 * w + s.m_b1 * m_v1 + s.m_b2 * m_v2;
+            const BiquadCoefficients<Value> c(s);
+            Value w = static_cast<Value>(in) - c.a1 * m_v1 - c.a2 * m_v2
+                + static_cast<Value>(vsa);
+            Value out = c.b0 * w + c.b1 * m_v1 + c.b2 * m_v2;
 
             m_v2 = m_v1;
             m_v1 = w;
@@ -102,11 +205,16 @@ namespace Dsp {
             return static_cast<Sample> (out);
         }
 
-    private:
-        double m_v1; // v[-1]
-        double m_v2; // v[-2]
+    protected:
+        template <class, class> friend struct LaneState;
+
+        Value m_v1; // v[-1]
+        Value m_v2; // v[-2]
     };
 
+    typedef BasicDirectFormII<double> DirectFormII;
+    typedef BasicDirectFormII<float> DirectFormIIFloat;
+
     //------------------------------------------------------------------------------
 
     /*
@@ -119,10 +227,13 @@ namespace Dsp {
      */
 
      // I think this one is broken
-    class TransposedDirectFormI
+    template <typename Value>
+    class BasicTransposedDirectFormI
     {
     public:
-        TransposedDirectFormI()
+        typedef Value value_type;
+
+        BasicTransposedDirectFormI()
         {
             reset();
         }
@@ -140,20 +251,21 @@ namespace Dsp {
             m_s4_1 = 0;
         }
 
-        template <typename Sample>
+        template <typename Sample, class Section>
         inline Sample process1(const Sample in,
-            const BiquadBase& s,
+            const Section& s,
             const double vsa)
         {
-            double out;
+            const BiquadCoefficients<Value> c(s);
+            Value out;
 
             // can be: in += m_s1_1;
-            m_v = in + m_s1_1;
-            out = s.m_b0 * m_v + m_s3_1;
-            m_s1 = m_s2_1 - s.m_a1 * m_v;
-            m_s2 = -s.m_a2 * m_v;
-            m_s3 = s.m_b1 * m_v + m_s4_1;
-            m_s4 = s.m_b2 * m_v;
+            m_v = static_cast<Value>(in) + m_s1_1;
+            out = c.b0 * m_v + m_s3_1;
+            m_s1 = m_s2_1 - c.a1 * m_v;
+            m_s2 = -c.a2 * m_v;
+            m_s3 = c.b1 * m_v + m_s4_1;
+            m_s4 = c.b2 * m_v;
 
             m_s4_1 = m_s4;
             m_s3_1 = m_s3;
@@ -164,23 +276,29 @@ namespace Dsp {
         }
 
     private:
-        double m_v;
-        double m_s1;
-        double m_s1_1;
-        double m_s2;
-        double m_s2_1;
-        double m_s3;
-        double m_s3_1;
-        double m_s4;
-        double m_s4_1;
+        Value m_v;
+        Value m_s1;
+        Value m_s1_1;
+        Value m_s2;
+        Value m_s2_1;
+        Value m_s3;
+        Value m_s3_1;
+        Value m_s4;
+        Value m_s4_1;
     };
 
+    typedef BasicTransposedDirectFormI<double> TransposedDirectFormI;
+    typedef BasicTransposedDirectFormI<float> TransposedDirectFormIFloat;
+
     //------------------------------------------------------------------------------
 
-    class TransposedDirectFormII
+    template <typename Value>
+    class BasicTransposedDirectFormII
     {
     public:
-        TransposedDirectFormII()
+        typedef Value value_type;
+
+        BasicTransposedDirectFormII()
         {
             reset();
         }
@@ -193,37 +311,709 @@ namespace Dsp {
             m_s2_1 = 0;
         }
 
-        template <typename Sample>
+        template <typename Sample, class Section>
         inline Sample process1(const Sample in,
-            const BiquadBase& s,
+            const Section& s,
             const double vsa)
         {
-            double out;
+            const BiquadCoefficients<Value> c(s);
+            const Value x = static_cast<Value>(in);
+            Value out;
 
-            out = m_s1_1 + s.m_b0 * in + vsa;
-            m_s1 = m_s2_1 + s.m_b1 * in - s.m_a1 * out;
-            m_s2 = s.m_b2 * in - s.m_a2 * out;
+            out = m_s1_1 + c.b0 * x + static_cast<Value>(vsa);
+            m_s1 = m_s2_1 + c.b1 * x - c.a1 * out;
+            m_s2 = c.b2 * x - c.a2 * out;
             m_s1_1 = m_s1;
             m_s2_1 = m_s2;
 
             return static_cast<Sample> (out);
         }
 
+    private:
+        template <class, class> friend struct LaneState;
+
+        Value m_s1;
+        Value m_s1_1;
+        Value m_s2;
+        Value m_s2_1;
+    };
+
+    typedef BasicTransposedDirectFormII<double> TransposedDirectFormII;
+    typedef BasicTransposedDirectFormII<float> TransposedDirectFormIIFloat;
+
+    // Positions of the vectorized forms in the kernel table, see Dispatch.h
+
+    template <>
+    struct Dispatch::FormIndex <DirectFormI>
+    {
+        enum { value = 0 };
+    };
+
+    template <>
+    struct Dispatch::FormIndex <DirectFormII>
+    {
+        enum { value = 1 };
+    };
+
+    template <>
+    struct Dispatch::FormIndex <TransposedDirectFormII>
+    {
+        enum { value = 2 };
+    };
+
+    template <>
+    struct Dispatch::FormIndex <DirectFormIFloat>
+    {
+        enum { value = 3 };
+    };
+
+    template <>
+    struct Dispatch::FormIndex <DirectFormIIFloat>
+    {
+        enum { value = 4 };
+    };
+
+    template <>
+    struct Dispatch::FormIndex <TransposedDirectFormIIFloat>
+    {
+        enum { value = 5 };
+    };
+
+    //------------------------------------------------------------------------------
+
+    /*
+     * Lane-parallel versions of the forms above, see LaneState in Simd.h.
+     * The expressions are kept in the same order as process1 so that every
+     * lane rounds exactly like the scalar code.
+     *
+     */
+
+    template <typename Value, class Vec>
+    struct LaneState <BasicDirectFormI<Value>, Vec>
+    {
+        typedef BasicDirectFormI<Value> StateType;
+
+        void load(StateType* const* stateArrays, int stage)
+        {
+            m_x1 = loadLanes<Vec>(stateArrays, stage, &StateType::m_x1);
+            m_x2 = loadLanes<Vec>(stateArrays, stage, &StateType::m_x2);
+            m_y1 = loadLanes<Vec>(stateArrays, stage, &StateType::m_y1);
+            m_y2 = loadLanes<Vec>(stateArrays, stage, &StateType::m_y2);
+        }
+
+        void store(StateType* const* stateArrays, int stage) const
+        {
+            storeLanes(stateArrays, stage, &StateType::m_x1, m_x1);
+            storeLanes(stateArrays, stage, &StateType::m_x2, m_x2);
+            storeLanes(stateArrays, stage, &StateType::m_y1, m_y1);
+            storeLanes(stateArrays, stage, &StateType::m_y2, m_y2);
+        }
+
+        inline Vec process1(const Vec& in,
+            const LaneBiquad<Vec>& s,
+            const Vec& vsa)
+        {
+            Vec out = s.b0 * in + s.b1 * m_x1 + s.b2 * m_x2
+                - s.a1 * m_y1 - s.a2 * m_y2
+                + vsa;
+            m_x2 = m_x1;
+            m_y2 = m_y1;
+            m_x1 = in;
+            m_y1 = out;
+
+            return out;
+        }
+
+    private:
+        Vec m_x2;
+        Vec m_y2;
+        Vec m_x1;
+        Vec m_y1;
+    };
+
+    template <typename Value, class Vec>
+    struct LaneState <BasicDirectFormII<Value>, Vec>
+    {
+        typedef BasicDirectFormII<Value> StateType;
+
+        void load(StateType* const* stateArrays, int stage)
+        {
+            m_v1 = loadLanes<Vec>(stateArrays, stage, &StateType::m_v1);
+            m_v2 = loadLanes<Vec>(stateArrays, stage, &StateType::m_v2);
+        }
+
+        void store(StateType* const* stateArrays, int stage) const
+        {
+            storeLanes(stateArrays, stage, &StateType::m_v1, m_v1);
+            storeLanes(stateArrays, stage, &StateType::m_v2, m_v2);
+        }
+
+        inline Vec process1(const Vec& in,
+            const LaneBiquad<Vec>& s,
+            const Vec& vsa)
+        {
+            Vec w = in - s.a1 * m_v1 - s.a2 * m_v2 + vsa;
+            Vec out = s.b0 * w + s.b1 * m_v1 + s.b2 * m_v2;
+
+            m_v2 = m_v1;
+            m_v1 = w;
+
+            return out;
+        }
+
+    private:
+        Vec m_v1;
+        Vec m_v2;
+    };
+
+    template <typename Value, class Vec>
+    struct LaneState <BasicTransposedDirectFormII<Value>, Vec>
+    {
+        typedef BasicTransposedDirectFormII<Value> StateType;
+
+        void load(StateType* const* stateArrays, int stage)
+        {
+            m_s1_1 = loadLanes<Vec>(stateArrays, stage, &StateType::m_s1_1);
+            m_s2_1 = loadLanes<Vec>(stateArrays, stage, &StateType::m_s2_1);
+        }
+
+        void store(StateType* const* stateArrays, int stage) const
+        {
+            storeLanes(stateArrays, stage, &StateType::m_s1, m_s1_1);
+            storeLanes(stateArrays, stage, &StateType::m_s1_1, m_s1_1);
+            storeLanes(stateArrays, stage, &StateType::m_s2, m_s2_1);
+            storeLanes(stateArrays, stage, &StateType::m_s2_1, m_s2_1);
+        }
+
+        inline Vec process1(const Vec& in,
+            const LaneBiquad<Vec>& s,
+            const Vec& vsa)
+        {
+            Vec out = m_s1_1 + s.b0 * in + vsa;
+            Vec s1 = m_s2_1 + s.b1 * in - s.a1 * out;
+            m_s2_1 = s.b2 * in - s.a2 * out;
+            m_s1_1 = s1;
+
+            return out;
+        }
+
+    private:
+        Vec m_s1_1;
+        Vec m_s2_1;
+    };
+
+    //------------------------------------------------------------------------------
+
+    /*
+     * Direct Form II for running a whole cascade as a skewed pipeline.
+     *
+     * Consecutive stages of a Cascade are placed in consecutive SIMD lanes
+     * with a one sample skew between them: while stage k processes sample n,
+     * stage k+1 processes sample n-1. A single channel then fills a vector
+     * register, at the cost of one sample of latency for every stage after
+     * the first (see Cascade::StateBase<SkewedDirectFormII>::getLatency).
+     * Apart from that delay the output is identical to DirectFormII.
+     *
+     * Each stage remembers its last output, which becomes the input of the
+     * next stage one sample later. With a lone Biquad this is DirectFormII.
+     *
+     */
+    class SkewedDirectFormII : public DirectFormII
+    {
+    public:
+        SkewedDirectFormII()
+            : m_y(0)
+        {
+        }
+
+        void reset()
+        {
+            DirectFormII::reset();
+            m_y = 0;
+        }
+
+        // Advances every stage by one sample, using the stage states
+        // in memory. Returns the output of the last stage.
+        template <class Stage>
+        static double process(const double in,
+            int numStages,
+            const Stage* stageArray,
+            SkewedDirectFormII* stateArray,
+            const double vsa)
+        {
+            // walk backwards so each stage reads its predecessor's
+            // output from the previous sample
+            for (int i = numStages; --i > 0;)
+                stateArray[i].m_y = stateArray[i].process1(
+                    stateArray[i - 1].m_y, stageArray[i], 0);
+            stateArray[0].m_y = stateArray[0].process1(in, stageArray[0], vsa);
+
+            return stateArray[numStages - 1].m_y;
+        }
+
+    private:
+        template <class> friend struct SkewedPipeline;
+
+        double m_y; // last output
+    };
+
+    //------------------------------------------------------------------------------
+
+    // Vectorized block kernel for SkewedDirectFormII. Stage k of the cascade
+    // lives in lane k % Vec::lanes of vector group k / Vec::lanes; lanes past
+    // the last stage have zero coefficients and never reach the output.
+    template <class Vec>
+    struct SkewedPipeline
+    {
+        enum
+        {
+            lanes = Vec::lanes,
+            maxGroups = 16
+        };
+
+        // Returns false if the cascade is too long for the kernel, in which
+        // case nothing has been processed.
+        template <class Stage, typename Sample>
+        static bool process(int numSamples,
+            Sample* dest,
+            int numStages,
+            const Stage* stageArray,
+            SkewedDirectFormII* stateArray,
+            DenormalPrevention& denormal)
+        {
+            const int numGroups = (numStages + lanes - 1) / lanes;
+            if (numStages < 1 || numGroups > maxGroups)
+                return false;
+
+            Vec b0[maxGroups];
+            Vec b1[maxGroups];
+            Vec b2[maxGroups];
+            Vec a1[maxGroups];
+            Vec a2[maxGroups];
+            Vec v1[maxGroups];
+            Vec v2[maxGroups];
+            Vec y[maxGroups];
+
+            for (int g = 0; g < numGroups; ++g)
+            {
+                double t[8][lanes];
+                for (int i = 0; i < lanes; ++i)
+                {
+                    const int k = g * lanes + i;
+                    if (k < numStages)
+                    {
+                        const SkewedDirectFormII& state = stateArray[k];
+                        const BiquadCoefficients<double> c(stageArray[k]);
+                        t[0][i] = c.b0;
+                        t[1][i] = c.b1;
+                        t[2][i] = c.b2;
+                        t[3][i] = c.a1;
+                        t[4][i] = c.a2;
+                        t[5][i] = state.m_v1;
+                        t[6][i] = state.m_v2;
+                        t[7][i] = state.m_y;
+                    }
+                    else
+                    {
+                        for (int j = 0; j < 8; ++j)
+                            t[j][i] = 0;
+                    }
+                }
+                b0[g] = Vec::load(t[0]);
+                b1[g] = Vec::load(t[1]);
+                b2[g] = Vec::load(t[2]);
+                a1[g] = Vec::load(t[3]);
+                a2[g] = Vec::load(t[4]);
+                v1[g] = Vec::load(t[5]);
+                v2[g] = Vec::load(t[6]);
+                y[g] = Vec::load(t[7]);
+            }
+
+            // the alternating denormal offset only goes into the first stage
+            double t[lanes];
+            double f[lanes];
+            for (int i = 0; i < lanes; ++i)
+            {
+                t[i] = 0;
+                f[i] = 1;
+            }
+            t[0] = denormal.getAc();
+            f[0] = -1;
+            Vec vsa = Vec::load(t);
+            const Vec flip = Vec::load(f);
+            const Vec zero = Vec::broadcast(0);
+
+            const int lastGroup = (numStages - 1) / lanes;
+            const int lastLane = (numStages - 1) % lanes;
+
+            while (--numSamples >= 0)
+            {
+                double carry = *dest;
+                for (int g = 0; g < numGroups; ++g)
+                {
+                    const Vec in = Simd::shiftIn(y[g], carry);
+                    carry = Simd::lastLane(y[g]);
+
+                    Vec v = zero;
+                    if (g == 0)
+                        v = vsa = vsa * flip;
+
+                    const Vec w = in - a1[g] * v1[g] - a2[g] * v2[g] + v;
+                    y[g] = b0[g] * w + b1[g] * v1[g] + b2[g] * v2[g];
+
+                    v2[g] = v1[g];
+                    v1[g] = w;
+                }
+
+                y[lastGroup].store(t);
+                *dest++ = static_cast<Sample>(t[lastLane]);
+            }
+
+            for (int g = 0; g < numGroups; ++g)
+            {
+                double u[3][lanes];
+                v1[g].store(u[0]);
+                v2[g].store(u[1]);
+                y[g].store(u[2]);
+                for (int i = 0; i < lanes && g * lanes + i < numStages; ++i)
+                {
+                    SkewedDirectFormII& state = stateArray[g * lanes + i];
+                    state.m_v1 = u[0][i];
+                    state.m_v2 = u[1][i];
+                    state.m_y = u[2][i];
+                }
+            }
+
+            vsa.store(t);
+            denormal.setAc(t[0]);
+
+            return true;
+        }
+    };
+
+    namespace Dispatch {
+
+        template <class Stage, typename Sample>
+        bool processSkewed(int numSamples,
+            Sample* dest,
+            int numStages,
+            const Stage* stageArray,
+            SkewedDirectFormII* stateArray,
+            DenormalPrevention& denormal,
+            Bool<false>)
+        {
+            return SkewedPipeline<Simd::Native>::process(numSamples, dest,
+                numStages, stageArray, stateArray, denormal);
+        }
+
+        template <class Stage, typename Sample>
+        bool processSkewed(int numSamples,
+            Sample* dest,
+            int numStages,
+            const Stage* stageArray,
+            SkewedDirectFormII* stateArray,
+            DenormalPrevention& denormal,
+            Bool<true>)
+        {
+            typedef typename SkewedKernel<Sample, Stage>::Type Kernel;
+
+            const KernelTable* table = getKernelTable();
+            if (!table)
+                return processSkewed(numSamples, dest, numStages,
+                    stageArray, stateArray, denormal, Bool<false>());
+
+            const Kernel kernel = reinterpret_cast<Kernel>(table->skewed
+                [SampleIndex<Sample>::value]
+                [StageIndex<Stage>::value]);
+
+            return kernel(numSamples, dest, numStages, stageArray,
+                stateArray, denormal);
+        }
+
+        // Runs SkewedPipeline with the best kernel for the processor.
+        // Returns false if nothing was processed.
+        template <class Stage, typename Sample>
+        bool processSkewed(int numSamples,
+            Sample* dest,
+            int numStages,
+            const Stage* stageArray,
+            SkewedDirectFormII* stateArray,
+            DenormalPrevention& denormal)
+        {
+            return processSkewed(numSamples, dest, numStages, stageArray,
+                stateArray, denormal, Bool<(
+                SampleIndex<Sample>::value >= 0 &&
+                StageIndex<Stage>::value >= 0)>());
+        }
+
+    }
+
+    //------------------------------------------------------------------------------
+
+    /*
+     * Block state-space form
+     *
+     * Treats the section as the 2x2 state-space system behind Transposed
+     * Direct Form II, with state x = (s1, s2):
+     *
+     *  y[n]   = s1[n] + b0*u[n]
+     *  x[n+1] = A*x[n] + B*u[n]
+     *
+     *  A = | -a1  1 |    B = | b1 - a1*b0 |
+     *      | -a2  0 |        | b2 - a2*b0 |
+     *
+     * A block of K outputs is computed at once from precomputed powers of A.
+     * Every output of the block depends only on the state at the start of
+     * the block and on the inputs, so the K outputs can be computed in
+     * parallel and the only serial dependency is one 2x2 state update per
+     * K samples. The matrices are rebuilt whenever the coefficients change.
+     *
+     * Single samples are processed with the ordinary TDFII recursion, so
+     * the results differ from TransposedDirectFormII only by rounding.
+     * Blocks are used when a Cascade processes a block of samples; this pays
+     * off for single sections and short cascades, where the recursion of
+     * one section leaves nothing else for the processor to overlap with.
+     *
+     */
+    template <int K = 4>
+    class BlockStateSpace
+    {
+    public:
+        typedef double value_type;
+
+        BlockStateSpace()
+        {
+            m_coef[0] = std::numeric_limits<double>::quiet_NaN();
+            reset();
+        }
+
+        void reset()
+        {
+            m_s1 = 0;
+            m_s2 = 0;
+        }
+
+        template <typename Sample>
+        inline Sample process1(const Sample in,
+            const BiquadBase& s,
+            const double vsa)
+        {
+            double out = m_s1 + s.m_b0 * in + vsa;
+            m_s1 = m_s2 + s.m_b1 * in - s.m_a1 * out;
+            m_s2 = s.m_b2 * in - s.m_a2 * out;
+
+            return static_cast<Sample> (out);
+        }
+
+        template <typename Sample>
+        inline Sample process1(const Sample in,
+            const BiquadCoefficients<double>& s,
+            const double vsa)
+        {
+            double out = m_s1 + s.b0 * in + vsa;
+            m_s1 = m_s2 + s.b1 * in - s.a1 * out;
+            m_s2 = s.b2 * in - s.a2 * out;
+
+            return static_cast<Sample> (out);
+        }
+
+        // Process a block of samples in place. vsa holds the denormal offset
+        // of the previous sample; it alternates in sign unless it is zero.
+        void process(int numSamples,
+            double* data,
+            const BiquadBase& s,
+            double& vsa)
+        {
+            update(s);
+
+            typedef typename Simd::Fit <K>::type Vec;
+            const int L = Vec::lanes;
+            const int N = K / L;
+
+            for (; numSamples >= K; numSamples -= K, data += K)
+            {
+                // outputs, with the input terms first and the state terms
+                // last so that only the state update is serial
+                Vec y[N];
+                for (int v = 0; v < N; ++v)
+                    y[v] = Vec::load(m_t[0] + v * L) * Vec::broadcast(data[0]);
+                for (int j = 1; j < K; ++j)
+                {
+                    const Vec u = Vec::broadcast(data[j]);
+                    for (int v = j / L; v < N; ++v)
+                        y[v] = y[v] + Vec::load(m_t[j] + v * L) * u;
+                }
+
+                double s1 = 0;
+                double s2 = 0;
+                for (int j = 0; j < K; ++j)
+                {
+                    s1 += m_g1[j] * data[j];
+                    s2 += m_g2[j] * data[j];
+                }
+
+                if (vsa != 0)
+                {
+                    // offset of the first sample, alternating from there
+                    const double e = -vsa;
+                    const Vec ev = Vec::broadcast(e);
+                    for (int v = 0; v < N; ++v)
+                        y[v] = y[v] + Vec::load(m_ey + v * L) * ev;
+                    s1 += e * m_ex1;
+                    s2 += e * m_ex2;
+                    if (K & 1)
+                        vsa = e;
+                }
+
+                const Vec x1 = Vec::broadcast(m_s1);
+                const Vec x2 = Vec::broadcast(m_s2);
+                for (int v = 0; v < N; ++v)
+                {
+                    y[v] = y[v] + (Vec::load(m_p1 + v * L) * x1 +
+                        Vec::load(m_p2 + v * L) * x2);
+                    y[v].store(data + v * L);
+                }
+
+                const double t1 = s1 + (m_ak[0] * m_s1 + m_ak[1] * m_s2);
+                m_s2 = s2 + (m_ak[2] * m_s1 + m_ak[3] * m_s2);
+                m_s1 = t1;
+            }
+
+            while (--numSamples >= 0)
+            {
+                if (vsa != 0)
+                    vsa = -vsa;
+                *data = process1(*data, s, vsa);
+                ++data;
+            }
+        }
+
+    private:
+        // Rebuilds the block matrices if the coefficients have changed
+        void update(const BiquadBase& s)
+        {
+            if (m_coef[0] == s.m_b0 && m_coef[1] == s.m_b1 &&
+                m_coef[2] == s.m_b2 && m_coef[3] == s.m_a1 &&
+                m_coef[4] == s.m_a2)
+                return;
+
+            m_coef[0] = s.m_b0;
+            m_coef[1] = s.m_b1;
+            m_coef[2] = s.m_b2;
+            m_coef[3] = s.m_a1;
+            m_coef[4] = s.m_a2;
+
+            // powers of A, stored row major
+            double a[K + 1][4];
+            a[0][0] = 1; a[0][1] = 0;
+            a[0][2] = 0; a[0][3] = 1;
+            for (int m = 1; m <= K; ++m)
+            {
+                const double* p = a[m - 1];
+                a[m][0] = -s.m_a1 * p[0] + p[2];
+                a[m][1] = -s.m_a1 * p[1] + p[3];
+                a[m][2] = -s.m_a2 * p[0];
+                a[m][3] = -s.m_a2 * p[1];
+            }
+
+            const double b1 = s.m_b1 - s.m_a1 * s.m_b0;
+            const double b2 = s.m_b2 - s.m_a2 * s.m_b0;
+
+            // impulse responses to the input and to the denormal offset,
+            // which enters like an extra input added to the output
+            double h[K];
+            double he[K];
+            h[0] = s.m_b0;
+            he[0] = 1;
+            for (int m = 1; m < K; ++m)
+            {
+                const double* p = a[m - 1];
+                h[m] = p[0] * b1 + p[1] * b2;
+                he[m] = -(p[0] * s.m_a1 + p[1] * s.m_a2);
+            }
+
+            for (int i = 0; i < K; ++i)
+            {
+                m_p1[i] = a[i][0];
+                m_p2[i] = a[i][1];
+
+                double e = 0;
+                for (int j = 0; j <= i; ++j)
+                    e += (j & 1) ? -he[i - j] : he[i - j];
+                m_ey[i] = e;
+            }
+
+            for (int j = 0; j < K; ++j)
+                for (int i = 0; i < K; ++i)
+                    m_t[j][i] = (i >= j) ? h[i - j] : 0;
+
+            for (int i = 0; i < 4; ++i)
+                m_ak[i] = a[K][i];
+
+            m_ex1 = 0;
+            m_ex2 = 0;
+            for (int j = 0; j < K; ++j)
+            {
+                const double* p = a[K - 1 - j];
+                m_g1[j] = p[0] * b1 + p[1] * b2;
+                m_g2[j] = p[2] * b1 + p[3] * b2;
+
+                const double sign = (j & 1) ? 1. : -1.;
+                m_ex1 += sign * (p[0] * s.m_a1 + p[1] * s.m_a2);
+                m_ex2 += sign * (p[2] * s.m_a1 + p[3] * s.m_a2);
+            }
+        }
+
     private:
         double m_s1;
-        double m_s1_1;
         double m_s2;
-        double m_s2_1;
+
+        double m_coef[5];  // coefficients the matrices were built from
+        double m_p1[K];    // first row of A^i
+        double m_p2[K];
+        double m_t[K][K];  // input to output, m_t[j][i] = h[i-j]
+        double m_ak[4];    // A^K
+        double m_g1[K];    // input to state, A^(K-1-j)*B
+        double m_g2[K];
+        double m_ey[K];    // offset to output
+        double m_ex1;      // offset to state
+        double m_ex2;
     };
 
     //------------------------------------------------------------------------------
 
+    /*
+     * Runs a Cascade of exactly Stages sections in the given form.
+     *
+     * This is not a form of its own but selects Cascade::StateBase
+     * <FixedStages>, which keeps the section states inside the state object
+     * and has the stage count as a constant, so the loop over the stages is
+     * unrolled at compile time. The filter must be set up with that many
+     * stages: (order + 1) / 2 for low and high pass designs, the order for
+     * band pass and band stop. Form is one of the vectorized forms. The
+     * output is identical to processing in Form.
+     *
+     */
+    template <int Stages, class Form = DirectFormII>
+    struct FixedStages
+    {
+    };
+
+    //------------------------------------------------------------------------------
+
+    // Channels argument for a channel count chosen at run time
+    enum
+    {
+        dynamicChannels = -1
+    };
+
     // Holds an array of states suitable for multi-channel processing
     template <int Channels, class StateType>
     class ChannelsState
     {
     public:
         ChannelsState()
+            : m_executor(0)
         {
         }
 
@@ -232,6 +1022,13 @@ namespace Dsp {
             return Channels;
         }
 
+        // Process the channels in parallel on executor, or on the calling
+        // thread if it is 0. The executor is not owned.
+        void setExecutor(ChannelExecutor* executor)
+        {
+            m_executor = executor;
+        }
+
         void reset()
         {
             for (int i = 0; i < Channels; ++i)
@@ -249,12 +1046,38 @@ namespace Dsp {
             Sample* const* arrayOfChannels,
             Filter& filter)
         {
-            for (int i = 0; i < Channels; ++i)
-                filter.process(numSamples, arrayOfChannels[i], m_state[i]);
+            ProcessChannelsTask<Filter, StateType, Sample> task =
+            { &filter, m_state, numSamples, arrayOfChannels };
+            runChannelGroups(m_executor, Channels, task);
+        }
+
+        // Process interleaved frames, frameStride samples apart
+        template <class Filter, typename Sample>
+        void process(int numSamples,
+            Sample* frames,
+            int frameStride,
+            Filter& filter)
+        {
+            ProcessFramesTask<Filter, StateType, Sample> task =
+            { &filter, m_state, numSamples, frames, frameStride };
+            runChannelGroups(m_executor, Channels, task);
+        }
+
+        // Process out of place, reading from sourceChannels
+        template <class Filter, typename Source, typename Sample>
+        void process(int numSamples,
+            const Source* const* sourceChannels,
+            Sample* const* arrayOfChannels,
+            Filter& filter)
+        {
+            ProcessFromTask<Filter, StateType, Source, Sample> task =
+            { &filter, m_state, numSamples, sourceChannels, arrayOfChannels };
+            runChannelGroups(m_executor, Channels, task);
         }
 
     private:
         StateType m_state[Channels];
+        ChannelExecutor* m_executor;
     };
 
     // Empty state, can't process anything
@@ -272,6 +1095,10 @@ namespace Dsp {
             throw std::logic_error("attempt to reset empty ChannelState");
         }
 
+        void setExecutor(ChannelExecutor*)
+        {
+        }
+
         template <class FilterDesign, typename Sample>
         void process(int numSamples,
             Sample* const* arrayOfChannels,
@@ -279,6 +1106,157 @@ namespace Dsp {
         {
             throw std::logic_error("attempt to process empty ChannelState");
         }
+
+        template <class FilterDesign, typename Sample>
+        void process(int,
+            Sample*,
+            int,
+            FilterDesign&)
+        {
+            throw std::logic_error("attempt to process empty ChannelState");
+        }
+
+        template <class FilterDesign, typename Source, typename Sample>
+        void process(int,
+            const Source* const*,
+            Sample* const*,
+            FilterDesign&)
+        {
+            throw std::logic_error("attempt to process empty ChannelState");
+        }
+    };
+
+    // States for a number of channels set at run time. All of them sit in
+    // one cache line aligned block, one instantiation serves any channel
+    // layout, and changing the count reallocates and resets every channel.
+    template <class StateType>
+    class ChannelsState <dynamicChannels, StateType>
+    {
+    public:
+        ChannelsState()
+            : m_numChannels(0)
+            , m_state(0)
+            , m_block(0)
+            , m_executor(0)
+        {
+        }
+
+        explicit ChannelsState(int numChannels)
+            : m_numChannels(0)
+            , m_state(0)
+            , m_block(0)
+            , m_executor(0)
+        {
+            setNumChannels(numChannels);
+        }
+
+        ~ChannelsState()
+        {
+            release();
+        }
+
+        int getNumChannels() const
+        {
+            return m_numChannels;
+        }
+
+        void setNumChannels(int numChannels)
+        {
+            assert(numChannels >= 0);
+
+            release();
+            if (numChannels > 0)
+            {
+                // the states hold pointers into themselves, so they are
+                // built in place and never copied
+                m_block = malloc(numChannels * sizeof(StateType) + alignment - 1);
+                if (!m_block)
+                    throw std::bad_alloc();
+
+                const size_t aligned = (size_t(m_block) + alignment - 1) & ~size_t(alignment - 1);
+                m_state = reinterpret_cast<StateType*>(aligned);
+                for (; m_numChannels < numChannels; ++m_numChannels)
+                    new (m_state + m_numChannels) StateType;
+            }
+        }
+
+        // Process the channels in parallel on executor, see the fixed
+        // channel count version
+        void setExecutor(ChannelExecutor* executor)
+        {
+            m_executor = executor;
+        }
+
+        void reset()
+        {
+            for (int i = 0; i < m_numChannels; ++i)
+                m_state[i].reset();
+        }
+
+        StateType& operator[] (int index)
+        {
+            assert(index >= 0 && index < m_numChannels);
+            return m_state[index];
+        }
+
+        template <class Filter, typename Sample>
+        void process(int numSamples,
+            Sample* const* arrayOfChannels,
+            Filter& filter)
+        {
+            ProcessChannelsTask<Filter, StateType, Sample> task =
+            { &filter, m_state, numSamples, arrayOfChannels };
+            runChannelGroups(m_executor, m_numChannels, task);
+        }
+
+        // Process interleaved frames, frameStride samples apart
+        template <class Filter, typename Sample>
+        void process(int numSamples,
+            Sample* frames,
+            int frameStride,
+            Filter& filter)
+        {
+            ProcessFramesTask<Filter, StateType, Sample> task =
+            { &filter, m_state, numSamples, frames, frameStride };
+            runChannelGroups(m_executor, m_numChannels, task);
+        }
+
+        // Process out of place, reading from sourceChannels
+        template <class Filter, typename Source, typename Sample>
+        void process(int numSamples,
+            const Source* const* sourceChannels,
+            Sample* const* arrayOfChannels,
+            Filter& filter)
+        {
+            ProcessFromTask<Filter, StateType, Source, Sample> task =
+            { &filter, m_state, numSamples, sourceChannels, arrayOfChannels };
+            runChannelGroups(m_executor, m_numChannels, task);
+        }
+
+    private:
+        enum
+        {
+            alignment = 64
+        };
+
+        void release()
+        {
+            for (int i = 0; i < m_numChannels; ++i)
+                m_state[i].~StateType();
+            free(m_block);
+            m_numChannels = 0;
+            m_state = 0;
+            m_block = 0;
+        }
+
+        ChannelsState(const ChannelsState&);
+        ChannelsState& operator= (const ChannelsState&);
+
+    private:
+        int m_numChannels;
+        StateType* m_state;
+        void* m_block;
+        ChannelExecutor* m_executor;
     };
 
     //------------------------------------------------------------------------------
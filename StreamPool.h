@@ -0,0 +1,239 @@
+#ifndef DSPFILTERS_STREAMPOOL_H
+#define DSPFILTERS_STREAMPOOL_H
+
+#include "Common.h"
+#include "Biquad.h"
+#include "Cascade.h"
+#include "MathSupplement.h"
+#include "Simd.h"
+#include "State.h"
+
+namespace Dsp {
+
+    /*
+     * Holds a large number of independent streams, each with its own small
+     * filter, for example thousands of sensor channels.
+     *
+     * Every stream in a pool has the same number of stages (a shorter
+     * filter is padded with pass-through sections, so one pool can hold
+     * RBJ biquads and second order Butterworth sections alike). Instead of
+     * an object per stream, the pool keeps the coefficients, the states and
+     * the denormal offsets of all streams in three contiguous slabs, stream
+     * after stream. Removing a stream moves the last one into its place, so
+     * the slabs never have holes and a block for every stream is one pass
+     * over each slab, Vec::lanes streams at a time in SIMD lanes.
+     *
+     * Streams are named by handles that stay valid until they are removed.
+     * The output of every stream is identical to running its filter alone.
+     *
+     */
+    template <class StateType = DirectFormII,
+        class Denormal = DenormalPrevention>
+        class StreamPool
+    {
+    public:
+        typedef int Handle;
+
+        explicit StreamPool(int numStages)
+            : m_numStages(numStages)
+        {
+            assert(numStages > 0);
+        }
+
+        int getNumStages() const
+        {
+            return m_numStages;
+        }
+
+        int getNumStreams() const
+        {
+            return static_cast<int>(m_handles.size());
+        }
+
+        // One more than the largest handle in use, the size of the buffer
+        // array that process() takes.
+        int getHandleRange() const
+        {
+            return static_cast<int>(m_slots.size());
+        }
+
+        // Make room for numStreams streams without reallocating
+        void reserve(int numStreams)
+        {
+            m_handles.reserve(numStreams);
+            m_stages.reserve(numStreams * m_numStages);
+            m_states.reserve(numStreams * m_numStages);
+            m_denormals.reserve(numStreams);
+        }
+
+        // Add a stream with the sections of a designed filter
+        Handle add(const Cascade& filter)
+        {
+            const Handle handle = allocate();
+            setFilter(handle, filter);
+            return handle;
+        }
+
+        // Add a stream with a single section, such as an RBJ filter
+        Handle add(const BiquadBase& biquad)
+        {
+            const Handle handle = allocate();
+            setFilter(handle, biquad);
+            return handle;
+        }
+
+        // Change the filter of a stream, keeping its state
+        void setFilter(Handle handle, const Cascade& filter)
+        {
+            const int numStages = filter.getNumStages();
+            assert(numStages <= m_numStages);
+
+            Stage* stage = &m_stages[slot(handle) * m_numStages];
+            filter.copyCompiledStages(stage);
+            for (int i = numStages; i < m_numStages; ++i)
+                stage[i] = passStage();
+        }
+
+        void setFilter(Handle handle, const BiquadBase& biquad)
+        {
+            Stage* stage = &m_stages[slot(handle) * m_numStages];
+            stage[0] = Stage(biquad);
+            for (int i = 1; i < m_numStages; ++i)
+                stage[i] = passStage();
+        }
+
+        void remove(Handle handle)
+        {
+            const int s = slot(handle);
+            const int last = getNumStreams() - 1;
+
+            if (s != last)
+            {
+                std::copy(m_stages.begin() + last * m_numStages,
+                    m_stages.begin() + (last + 1) * m_numStages,
+                    m_stages.begin() + s * m_numStages);
+                std::copy(m_states.begin() + last * m_numStages,
+                    m_states.begin() + (last + 1) * m_numStages,
+                    m_states.begin() + s * m_numStages);
+                m_denormals[s] = m_denormals[last];
+                m_handles[s] = m_handles[last];
+                m_slots[m_handles[s]] = s;
+            }
+
+            m_stages.resize(last * m_numStages);
+            m_states.resize(last * m_numStages);
+            m_denormals.pop_back();
+            m_handles.pop_back();
+
+            m_slots[handle] = -1;
+            m_freeHandles.push_back(handle);
+        }
+
+        void reset(Handle handle)
+        {
+            StateType* state = &m_states[slot(handle) * m_numStages];
+            for (int i = 0; i < m_numStages; ++i)
+                state[i].reset();
+        }
+
+        void reset()
+        {
+            for (size_t i = 0; i < m_states.size(); ++i)
+                m_states[i].reset();
+        }
+
+        // Process a block of samples for every stream, buffers[handle]
+        // being the samples of the stream with that handle. The array
+        // covers getHandleRange(); entries of free handles are not used.
+        template <typename Sample>
+        void process(int numSamples, Sample* const* buffers)
+        {
+            typedef typename LaneVectors<StateType>::native_t Vec;
+            typedef typename LaneVectors<StateType>::scalar_t Single;
+
+            typename Denormal::Scope scope;
+
+            const int numStreams = getNumStreams();
+            int first = 0;
+            for (; numStreams - first >= Vec::lanes; first += Vec::lanes)
+                processStreams<Vec>(numSamples, first, buffers);
+            for (; first < numStreams; ++first)
+                processStreams<Single>(numSamples, first, buffers);
+        }
+
+    private:
+        typedef BiquadCoefficients<typename StateType::value_type> Stage;
+
+        static Stage passStage()
+        {
+            Biquad identity;
+            identity.setCoefficients(1, 0, 0, 1, 0, 0);
+            return Stage(identity);
+        }
+
+        int slot(Handle handle) const
+        {
+            assert(handle >= 0 && handle < getHandleRange() && m_slots[handle] >= 0);
+            return m_slots[handle];
+        }
+
+        Handle allocate()
+        {
+            Handle handle;
+            if (m_freeHandles.empty())
+            {
+                handle = getHandleRange();
+                m_slots.push_back(-1);
+            }
+            else
+            {
+                handle = m_freeHandles.back();
+                m_freeHandles.pop_back();
+            }
+
+            m_slots[handle] = getNumStreams();
+            m_handles.push_back(handle);
+            m_stages.resize(m_stages.size() + m_numStages);
+            m_states.resize(m_states.size() + m_numStages, StateType());
+            m_denormals.push_back(Denormal());
+
+            return handle;
+        }
+
+        template <class Vec, typename Sample>
+        void processStreams(int numSamples, int first, Sample* const* buffers)
+        {
+            Sample* channels[Vec::lanes];
+            const Stage* stages[Vec::lanes];
+            StateType* states[Vec::lanes];
+            DenormalPrevention* denormals[Vec::lanes];
+            for (int i = 0; i < Vec::lanes; ++i)
+            {
+                const int s = first + i;
+                channels[i] = buffers[m_handles[s]];
+                stages[i] = &m_stages[s * m_numStages];
+                states[i] = &m_states[s * m_numStages];
+                denormals[i] = &m_denormals[s];
+            }
+
+            processLanes<Vec>(numSamples, m_numStages, LaneStages<Stage>(stages),
+                channels, channels, states, denormals, 1);
+        }
+
+    private:
+        int m_numStages;
+
+        // The slabs, in slot order
+        std::vector<Stage> m_stages;
+        std::vector<StateType> m_states;
+        std::vector<Denormal> m_denormals;
+        std::vector<Handle> m_handles;
+
+        // Slot of each handle, -1 if free
+        std::vector<int> m_slots;
+        std::vector<Handle> m_freeHandles;
+    };
+
+}
+
+#endif
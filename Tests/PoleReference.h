@@ -0,0 +1,411 @@
+#ifndef DSPFILTERS_TESTS_POLEREFERENCE_H
+#define DSPFILTERS_TESTS_POLEREFERENCE_H
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+//
+// Bessel and Legendre analog poles found in double-double arithmetic, as a
+// reference for the pole tables and for RootFinder. Double-double carries
+// about 32 digits; rounding in evaluating the polynomials near their roots
+// leaves the poles of order 25 good to about 1e-19 of their magnitude,
+// still well past the 17 digits of the tables. Needs strict IEEE double
+// arithmetic, so do not build it with /fp:fast or -ffast-math.
+//
+
+namespace Reference {
+
+    // hi + lo, with lo no more than half an ulp of hi
+    struct Real
+    {
+        Real(double hi_ = 0, double lo_ = 0)
+            : hi(hi_)
+            , lo(lo_)
+        {
+        }
+
+        double hi;
+        double lo;
+    };
+
+    inline Real quickTwoSum(double a, double b)
+    {
+        const double s = a + b;
+        return Real(s, b - (s - a));
+    }
+
+    inline Real twoSum(double a, double b)
+    {
+        const double s = a + b;
+        const double bb = s - a;
+        return Real(s, (a - (s - bb)) + (b - bb));
+    }
+
+    inline Real operator+ (const Real& a, const Real& b)
+    {
+        Real s = twoSum(a.hi, b.hi);
+        const Real t = twoSum(a.lo, b.lo);
+        s.lo += t.hi;
+        s = quickTwoSum(s.hi, s.lo);
+        s.lo += t.lo;
+        return quickTwoSum(s.hi, s.lo);
+    }
+
+    inline Real operator- (const Real& a)
+    {
+        return Real(-a.hi, -a.lo);
+    }
+
+    inline Real operator- (const Real& a, const Real& b)
+    {
+        return a + -b;
+    }
+
+    inline Real operator* (const Real& a, const Real& b)
+    {
+        const double p = a.hi * b.hi;
+        const double e = std::fma(a.hi, b.hi, -p) + (a.hi * b.lo + a.lo * b.hi);
+        return quickTwoSum(p, e);
+    }
+
+    inline Real operator/ (const Real& a, const Real& b)
+    {
+        const double q1 = a.hi / b.hi;
+        Real r = a - b * q1;
+        const double q2 = r.hi / b.hi;
+        r = r - b * q2;
+        const double q3 = r.hi / b.hi;
+        return quickTwoSum(q1, q2) + q3;
+    }
+
+    inline Real sqrt(const Real& a)
+    {
+        if (a.hi <= 0)
+            return Real();
+
+        // one Newton step from the double root doubles the digits
+        const Real x = std::sqrt(a.hi);
+        return x + (a - x * x) / (2 * x);
+    }
+
+    // Nearest double
+    inline double toDouble(const Real& a)
+    {
+        return a.hi;
+    }
+
+    //------------------------------------------------------------------------------
+
+    struct Complex
+    {
+        Complex(const Real& re_ = Real(), const Real& im_ = Real())
+            : re(re_)
+            , im(im_)
+        {
+        }
+
+        Real re;
+        Real im;
+    };
+
+    inline Complex operator+ (const Complex& a, const Complex& b)
+    {
+        return Complex(a.re + b.re, a.im + b.im);
+    }
+
+    inline Complex operator- (const Complex& a, const Complex& b)
+    {
+        return Complex(a.re - b.re, a.im - b.im);
+    }
+
+    inline Complex operator* (const Complex& a, const Complex& b)
+    {
+        return Complex(a.re * b.re - a.im * b.im, a.re * b.im + a.im * b.re);
+    }
+
+    inline Complex operator/ (const Complex& a, const Complex& b)
+    {
+        const Real d = b.re * b.re + b.im * b.im;
+        return Complex((a.re * b.re + a.im * b.im) / d,
+            (a.im * b.re - a.re * b.im) / d);
+    }
+
+    inline double magnitude(const Complex& a)
+    {
+        return std::hypot(toDouble(a.re), toDouble(a.im));
+    }
+
+    //------------------------------------------------------------------------------
+
+    // Finds the roots of the polynomial of degree whose value and derivative
+    // at z poly(z, p, dp) returns, with the Aberth-Ehrlich iteration started
+    // on a circle of radius. Returns false if it does not converge.
+    template <class Poly>
+    bool findRoots(const Poly& poly,
+        int degree,
+        double radius,
+        std::vector<Complex>& roots)
+    {
+        const double pi = 3.1415926535897932384626433832795;
+
+        roots.resize(degree);
+        for (int i = 0; i < degree; ++i)
+        {
+            const double t = 2 * pi * (i + 0.25) / degree;
+            roots[i] = Complex(radius * std::cos(t), radius * std::sin(t));
+        }
+
+        // corrections stop shrinking at the rounding error of evaluating
+        // the polynomial, about 1e-25 of a root at order 15 and 1e-19 at
+        // order 25. A few more iterations settle every root there.
+        int settle = -1;
+        for (int iteration = 0; iteration < 1000 && settle != 0; ++iteration)
+        {
+            double largest = 0;
+            for (int i = 0; i < degree; ++i)
+            {
+                Complex p;
+                Complex dp;
+                poly(roots[i], p, dp);
+                if (p.re.hi == 0 && p.im.hi == 0)
+                    continue;
+
+                const Complex ratio = p / dp;
+                Complex sum;
+                for (int j = 0; j < degree; ++j)
+                    if (j != i)
+                        sum = sum + Complex(1) / (roots[i] - roots[j]);
+
+                const Complex w = ratio / (Complex(1) - ratio * sum);
+                roots[i] = roots[i] - w;
+                largest = std::max(largest,
+                    magnitude(w) / std::max(magnitude(roots[i]), 1e-300));
+            }
+
+            if (settle > 0)
+                --settle;
+            else if (settle < 0 && largest < 1e-18)
+                settle = 3;
+        }
+
+        return settle == 0;
+    }
+
+    // Descending imaginary part, the order RootFinderBase::sort() uses
+    inline void sortRoots(std::vector<Complex>& roots)
+    {
+        for (size_t j = 1; j < roots.size(); ++j)
+        {
+            const Complex x = roots[j];
+            size_t i = j;
+            for (; i > 0 && toDouble(roots[i - 1].im) < toDouble(x.im); --i)
+                roots[i] = roots[i - 1];
+            roots[i] = x;
+        }
+    }
+
+    // Keeps one of each conjugate pair, then the real root of an odd count,
+    // as the pole tables list them. Imaginary parts within the rounding
+    // error of the real one are zeroed.
+    inline void tableOrder(std::vector<Complex>& roots)
+    {
+        for (size_t i = 0; i < roots.size(); ++i)
+            if (std::fabs(toDouble(roots[i].im)) <
+                1e-17 * std::fabs(toDouble(roots[i].re)))
+                roots[i].im = Real();
+
+        sortRoots(roots);
+        roots.resize((roots.size() + 1) / 2);
+    }
+
+    //------------------------------------------------------------------------------
+
+    // The reverse Bessel polynomial of order n from its three term
+    // recurrence, theta(k) = (2k - 1) theta(k - 1) + s^2 theta(k - 2)
+    struct BesselPolynomial
+    {
+        explicit BesselPolynomial(int n_)
+            : n(n_)
+        {
+        }
+
+        void operator() (const Complex& s, Complex& p, Complex& dp) const
+        {
+            const Complex s2 = s * s;
+            Complex t0(1);
+            Complex d0;
+            Complex t1 = s + Complex(1);
+            Complex d1(1);
+            for (int k = 2; k <= n; ++k)
+            {
+                const Complex c(2. * k - 1);
+                const Complex t2 = c * t1 + s2 * t0;
+                const Complex d2 = c * d1 + Complex(2) * s * t0 + s2 * d0;
+                t0 = t1;
+                d0 = d1;
+                t1 = t2;
+                d1 = d2;
+            }
+            p = t1;
+            dp = d1;
+        }
+
+        int n;
+    };
+
+    // Poles of the Bessel filter of order n, in table order
+    inline bool besselPoles(int n, std::vector<Complex>& poles)
+    {
+        // the roots multiply to theta(0) = (2n)! / (n! 2^n), put the circle
+        // at their geometric mean
+        double logProduct = 0;
+        for (int k = n + 1; k <= 2 * n; ++k)
+            logProduct += std::log(k / 2.);
+
+        if (!findRoots(BesselPolynomial(n), n, std::exp(logProduct / n), poles))
+            return false;
+
+        tableOrder(poles);
+        return true;
+    }
+
+    //------------------------------------------------------------------------------
+
+    // Coefficients w[0..2n] of the Legendre (optimum L) filter of order n,
+    // |H(jw)|^2 = 1 / (1 + w(w^2)), following
+    // Legendre::PolynomialFinderBase::solve() step by step
+    inline void legendreMagnitude(int n, std::vector<Real>& w)
+    {
+        const int k = (n - 1) / 2;
+
+        std::vector<Real> a(k + 1);
+        if (n & 1)
+        {
+            for (int i = 0; i <= k; ++i)
+                a[i] = Real(2. * i + 1) / (sqrt(Real(2)) * (k + 1.));
+        }
+        else
+        {
+            for (int i = (k & 1) ? 1 : 0; i <= k; i += 2)
+                a[i] = Real(2. * i + 1) / sqrt(Real((k + 1.) * (k + 2.)));
+        }
+
+        // s = sum of a[i] P[i], with the Legendre polynomials P from
+        // (i + 1) P(i + 1) = (2i + 1) x P(i) - i P(i - 1)
+        std::vector<Real> s(n + 2);
+        std::vector<Real> previous(n + 2);
+        std::vector<Real> current(n + 2);
+        current[0] = 1;
+        for (int i = 0; i <= k; ++i)
+        {
+            if (i > 0)
+            {
+                std::vector<Real> next(n + 2);
+                for (int j = 0; j <= i - 1; ++j)
+                    next[j + 1] = next[j + 1] + Real(2. * i - 1) * current[j] / i;
+                for (int j = 0; j <= i - 2; ++j)
+                    next[j] = next[j] - Real(i - 1.) * previous[j] / i;
+                previous = current;
+                current = next;
+            }
+            for (int j = 0; j <= i; ++j)
+                s[j] = s[j] + a[i] * current[j];
+        }
+
+        // v = s^2, times (1 + x) for an even order
+        std::vector<Real> v(2 * n + 4);
+        for (int i = 0; i <= k; ++i)
+            for (int j = 0; j <= k; ++j)
+                v[i + j] = v[i + j] + s[i] * s[j];
+        v[2 * k + 1] = Real();
+        if ((n & 1) == 0)
+            for (int i = n; i >= 0; --i)
+                v[i + 1] = v[i + 1] + v[i];
+
+        // integrate v from -1 to 2x^2 - 1
+        for (int i = n + 1; i >= 0; --i)
+            v[i + 1] = v[i] / (i + 1.);
+        v[0] = Real();
+
+        std::vector<Real> t(n + 2);
+        w.assign(n + 2, Real());
+        t[0] = -1;
+        t[1] = 2;
+        for (int i = 1; i <= n; ++i)
+        {
+            if (i > 1)
+            {
+                Real c0 = -t[0];
+                for (int j = 1; j < i + 1; ++j)
+                {
+                    const Real c1 = -t[j] + 2 * t[j - 1];
+                    t[j - 1] = c0;
+                    c0 = c1;
+                }
+                const Real c1 = 2 * t[i];
+                t[i] = c0;
+                t[i + 1] = c1;
+            }
+            for (int j = i; j > 0; --j)
+                w[j] = w[j] + v[i] * t[j];
+        }
+        if ((n & 1) == 0)
+            w[1] = Real();
+    }
+
+    // 1 + w(-s^2) by Horner's rule
+    struct LegendrePolynomial
+    {
+        explicit LegendrePolynomial(int n)
+            : coef(2 * n + 1)
+        {
+            std::vector<Real> w;
+            legendreMagnitude(n, w);
+            coef[0] = 1 + w[0];
+            for (int i = 1; i <= n; ++i)
+                coef[2 * i] = (i & 1) ? -w[i] : w[i];
+        }
+
+        void operator() (const Complex& s, Complex& p, Complex& dp) const
+        {
+            p = Complex();
+            dp = Complex();
+            for (size_t i = coef.size(); i-- > 0;)
+            {
+                dp = dp * s + p;
+                p = p * s + Complex(coef[i]);
+            }
+        }
+
+        std::vector<Real> coef;
+    };
+
+    // Poles of the Legendre filter of order n, in table order
+    inline bool legendrePoles(int n, std::vector<Complex>& poles)
+    {
+        const LegendrePolynomial poly(n);
+        const int degree = 2 * n;
+        const double radius = std::pow(std::fabs(toDouble(poly.coef[0]) /
+            toDouble(poly.coef[degree])), 1. / degree);
+
+        std::vector<Complex> roots;
+        if (!findRoots(poly, degree, radius, roots))
+            return false;
+
+        // the roots are symmetric about the imaginary axis, the poles are
+        // the left half
+        poles.clear();
+        for (int i = 0; i < degree; ++i)
+            if (toDouble(roots[i].re) < 0)
+                poles.push_back(roots[i]);
+        if (int(poles.size()) != n)
+            return false;
+
+        tableOrder(poles);
+        return true;
+    }
+
+}
+
+#endif
@@ -0,0 +1,86 @@
+#ifndef DSPFILTERS_TESTS_POLESOLVERS_H
+#define DSPFILTERS_TESTS_POLESOLVERS_H
+
+#include "../DSP.h"
+
+#include <vector>
+
+//
+// The Bessel and Legendre poles solved the way their design() does past
+// the pole tables, with either RootFinder method, in table order.
+//
+
+namespace Solvers {
+
+    const int tableOrders = 25;
+
+    typedef std::vector<Dsp::complex_t> Poles;
+
+    // Largest distance from the reference relative to the pole
+    inline double deviation(const Poles& poles, const Poles& reference)
+    {
+        if (poles.size() != reference.size())
+            return 1;
+
+        double largest = 0;
+        for (size_t i = 0; i < poles.size(); ++i)
+            largest = std::max(largest,
+                std::abs(poles[i] - reference[i]) / std::abs(reference[i]));
+        return largest;
+    }
+
+    // Table order from roots sorted by descending imaginary part
+    inline Poles tableOrder(const Dsp::complex_t* roots, int n)
+    {
+        Poles poles(roots, roots + (n + 1) / 2);
+        if (n & 1)
+            poles.back() = Dsp::complex_t(poles.back().real(), 0);
+        return poles;
+    }
+
+    inline double reverseBessel(int k, int n)
+    {
+        // (2n - k)! / ((n - k)! k! 2^(n - k))
+        double y = 1;
+        for (int i = n - k + 1; i <= 2 * n - k; ++i)
+            y *= i;
+        for (int i = 2; i <= k; ++i)
+            y /= i;
+        return std::ldexp(y, k - n);
+    }
+
+    // The poles Bessel::AnalogLowPass::design() solves for
+    inline Poles solveBessel(int n, Dsp::RootFinderBase::Method method)
+    {
+        Dsp::RootFinder <tableOrders> solver;
+        for (int i = 0; i < n + 1; ++i)
+            solver.coef()[i] = reverseBessel(i, n);
+        solver.solve(n, true, true, method);
+        return tableOrder(solver.root(), n);
+    }
+
+    // The poles Legendre::AnalogLowPass::design() solves for
+    inline Poles solveLegendre(int n, Dsp::RootFinderBase::Method method)
+    {
+        Dsp::Legendre::Workspace <tableOrders> w;
+        w.poly.solve(n);
+
+        const int degree = 2 * n;
+        for (int i = 0; i <= degree; ++i)
+            w.roots.coef()[i] = 0;
+        w.roots.coef()[0] = 1 + w.poly.coef()[0];
+        for (int i = 1; i <= n; ++i)
+            w.roots.coef()[2 * i] = w.poly.coef()[i] * ((i & 1) ? -1 : 1);
+        w.roots.solve(degree, true, true, method);
+
+        int j = 0;
+        for (int i = 0; i < degree; ++i)
+            if (w.roots.root()[i].real() <= 0)
+                w.roots.root()[j++] = w.roots.root()[i];
+        w.roots.sort(n);
+        return tableOrder(w.roots.root(), n);
+    }
+
+}
+
+#endif
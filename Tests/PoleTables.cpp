@@ -0,0 +1,127 @@
+//
+// Checks the Bessel and Legendre pole tables against poles found in
+// double-double arithmetic (see PoleReference.h), and how far RootFinder,
+// which designs the orders past the tables, is from them.
+//
+// Every table entry must be within tableTolerance of the reference,
+// relative to the magnitude of the pole, which 17 digit entries are with
+// room to spare. The RootFinder deviation is reported for both methods
+// and must stay within solverTolerance. It grows about threefold every
+// order, to 1e-3 at order 25, because the polynomials are ill conditioned
+// in double whichever method solves them.
+//
+// Build it as a console program together with the library sources except
+// dllmain.cpp. Run with "print" to write out the tables from the reference.
+//
+
+#include "../DSP.h"
+#include "PoleReference.h"
+#include "PoleSolvers.h"
+
+#include <cstdio>
+#include <cstring>
+
+namespace {
+
+    const double tableTolerance = 1e-15;
+    const double solverTolerance = 1e-2;
+
+    Solvers::Poles toPoles(const std::vector<Reference::Complex>& roots)
+    {
+        Solvers::Poles poles;
+        for (size_t i = 0; i < roots.size(); ++i)
+            poles.push_back(Dsp::complex_t(Reference::toDouble(roots[i].re),
+                Reference::toDouble(roots[i].im)));
+        return poles;
+    }
+
+    // The poles design() takes from the table
+    template <class AnalogLowPass, class Workspace>
+    Solvers::Poles designPoles(int n)
+    {
+        Dsp::Layout <Solvers::tableOrders> storage;
+        AnalogLowPass analog;
+        analog.setStorage(storage);
+        Workspace w;
+        analog.design(n, &w);
+
+        Solvers::Poles poles;
+        for (int i = 0; i < (n + 1) / 2; ++i)
+            poles.push_back(analog[i].poles.first);
+        return poles;
+    }
+
+    void print(const char* family,
+        bool (*reference)(int, std::vector<Reference::Complex>&))
+    {
+        std::printf("        // %s\n", family);
+        std::printf("        static const complex_t poleTable[] =\n        {\n");
+        for (int n = 1; n <= Solvers::tableOrders; ++n)
+        {
+            std::vector<Reference::Complex> roots;
+            reference(n, roots);
+            const Solvers::Poles poles = toPoles(roots);
+
+            std::printf("            // order %d\n", n);
+            for (size_t i = 0; i < poles.size(); ++i)
+                std::printf("            complex_t(%.17g, %.17g),\n",
+                    poles[i].real(), poles[i].imag());
+        }
+        std::printf("        };\n\n");
+    }
+
+    template <class AnalogLowPass, class Workspace>
+    bool check(const char* family,
+        bool (*reference)(int, std::vector<Reference::Complex>&),
+        Solvers::Poles (*solve)(int, Dsp::RootFinderBase::Method))
+    {
+        bool ok = true;
+        std::printf("%-8s order    table  laguerre    aberth\n", family);
+        for (int n = 1; n <= Solvers::tableOrders; ++n)
+        {
+            std::vector<Reference::Complex> roots;
+            if (!reference(n, roots))
+            {
+                std::printf("%-8s %5d reference did not converge\n", family, n);
+                ok = false;
+                continue;
+            }
+
+            const Solvers::Poles poles = toPoles(roots);
+            const double table = Solvers::deviation(
+                designPoles<AnalogLowPass, Workspace>(n), poles);
+            const double laguerre = Solvers::deviation(
+                solve(n, Dsp::RootFinderBase::methodLaguerre), poles);
+            const double aberth = Solvers::deviation(
+                solve(n, Dsp::RootFinderBase::methodAberth), poles);
+
+            const bool pass = table <= tableTolerance &&
+                laguerre <= solverTolerance && aberth <= solverTolerance;
+            std::printf("%-8s %5d %8.1e  %8.1e  %8.1e%s\n", family, n,
+                table, laguerre, aberth, pass ? "" : "  FAILED");
+            ok = ok && pass;
+        }
+        return ok;
+    }
+
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc > 1 && std::strcmp(argv[1], "print") == 0)
+    {
+        print("Bessel", Reference::besselPoles);
+        print("Legendre", Reference::legendrePoles);
+        return 0;
+    }
+
+    const bool bessel = check<Dsp::Bessel::AnalogLowPass,
+        Dsp::Bessel::Workspace <Solvers::tableOrders> >("bessel",
+            Reference::besselPoles, Solvers::solveBessel);
+    const bool legendre = check<Dsp::Legendre::AnalogLowPass,
+        Dsp::Legendre::Workspace <Solvers::tableOrders> >("legendre",
+            Reference::legendrePoles, Solvers::solveLegendre);
+
+    std::printf("%s\n", bessel && legendre ? "passed" : "FAILED");
+    return bessel && legendre ? 0 : 1;
+}
@@ -0,0 +1,91 @@
+//
+// Compares the Laguerre and Aberth-Ehrlich methods of RootFinder on the
+// Bessel and Legendre polynomials of orders 1 to 25, which their design()
+// solves past the pole tables, and times a solve of each.
+//
+// The poles the two methods find for an order must agree within
+// methodTolerance(order), relative to the magnitude of the pole. Both are
+// limited by how ill conditioned the polynomials are in double, not by
+// the method, and that error grows about threefold every order (see
+// PoleTables.cpp), so the tolerance does as well.
+//
+// Build it as a console program together with the library sources except
+// dllmain.cpp, with optimization, so that the times mean something.
+//
+
+#include "../DSP.h"
+#include "PoleSolvers.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+
+namespace {
+
+    double methodTolerance(int order)
+    {
+        return 1e-14 * std::pow(3., order);
+    }
+
+    // Microseconds per call of solve(order, method)
+    double solveTime(Solvers::Poles (*solve)(int, Dsp::RootFinderBase::Method),
+        int order,
+        Dsp::RootFinderBase::Method method)
+    {
+        typedef std::chrono::steady_clock clock;
+
+        // best of several runs of at least 2 ms each
+        double best = 0;
+        for (int run = 0; run < 5; ++run)
+        {
+            int count = 0;
+            const clock::time_point start = clock::now();
+            clock::duration elapsed;
+            do
+            {
+                solve(order, method);
+                ++count;
+                elapsed = clock::now() - start;
+            } while (elapsed < std::chrono::milliseconds(2));
+
+            const double us =
+                std::chrono::duration<double, std::micro>(elapsed).count() / count;
+            if (run == 0 || us < best)
+                best = us;
+        }
+        return best;
+    }
+
+    bool compare(const char* family,
+        Solvers::Poles (*solve)(int, Dsp::RootFinderBase::Method))
+    {
+        bool ok = true;
+        std::printf("%-8s order  difference  tolerance  laguerre us  aberth us\n",
+            family);
+        for (int n = 1; n <= Solvers::tableOrders; ++n)
+        {
+            const double difference = Solvers::deviation(
+                solve(n, Dsp::RootFinderBase::methodAberth),
+                solve(n, Dsp::RootFinderBase::methodLaguerre));
+            const bool pass = difference <= methodTolerance(n);
+
+            std::printf("%-8s %5d  %10.1e  %9.1e  %11.2f  %9.2f%s\n", family, n,
+                difference, methodTolerance(n),
+                solveTime(solve, n, Dsp::RootFinderBase::methodLaguerre),
+                solveTime(solve, n, Dsp::RootFinderBase::methodAberth),
+                pass ? "" : "  FAILED");
+            ok = ok && pass;
+        }
+        return ok;
+    }
+
+}
+
+int main()
+{
+    const bool bessel = compare("bessel", Solvers::solveBessel);
+    const bool legendre = compare("legendre", Solvers::solveLegendre);
+
+    std::printf("%s\n", bessel && legendre ? "passed" : "FAILED");
+    return bessel && legendre ? 0 : 1;
+}
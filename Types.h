@@ -99,6 +99,13 @@ namespace Dsp {
         kindOther
     };
 
+    // Spacing of the points of a frequency grid, see Cascade::responseGrid
+    enum Spacing
+    {
+        spacingLinear,
+        spacingLogarithmic
+    };
+
 }
 
 #endif
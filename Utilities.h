@@ -2,6 +2,7 @@
 #define DSPFILTERS_UTILITIES_H
 
 #include "Common.h"
+#include "Dispatch.h"
 
 namespace Dsp {
 
@@ -36,8 +37,7 @@ namespace Dsp {
         }
         else
         {
-            while (--samples >= 0)
-                *dest++ += static_cast<Td>(*src++);
+            Dispatch::add(samples, dest, src);
         }
     }
 
@@ -348,10 +348,7 @@ namespace Dsp {
         }
         else
         {
-            while (--samples >= 0) {
-                *dest = static_cast<Td>(*dest * factor);
-                dest++;
-            }
+            Dispatch::multiply(samples, dest, factor);
         }
     }
 